@@ -0,0 +1,64 @@
+#include <iostream>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+#define piece 64
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto input = [](){ return range(0, csize).materialize(); };
+    auto inc = [](int x) {return x+1;};
+    auto odd = [](int x) {return x % 2 == 1;};
+    auto dbl = [](int x) {return x*2;};
+    auto add = [](int x, int y) {return x+y;};
+    auto big = [](int x) {return x > 100;};
+
+    // a 5-stage pipeline whose every stage allocates an intermediate
+    auto pipeline = [&](const Collection<int>& c) {
+        auto odds = c.map(inc).filter(odd);
+        auto doubled = odds.map(dbl);
+        return zipWith(add, odds, doubled).filter(big).size();
+    };
+
+    std::cout << "Comparing heap & arena allocated map/filter/map/zipWith/filter pipelines "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](Collection<int> i) {
+        return pipeline(i);
+    }, trials, "heap: one pipeline");
+
+    Arena arena;
+    bench(input, [&](Collection<int> i) {
+        ScopedArena scope(arena);
+        return pipeline(i);
+    }, trials, "arena: one pipeline");
+
+    bench(input, [&](Collection<int> i) {
+        int total = 0;
+        for (int low = 0; low + piece <= i.size(); low += piece)
+            total += pipeline(i.slice(low, low + piece));
+        return total;
+    }, trials, "heap: a pipeline per slice of " + std::to_string(piece));
+
+    bench(input, [&](Collection<int> i) {
+        int total = 0;
+        for (int low = 0; low + piece <= i.size(); low += piece) {
+            ScopedArena scope(arena);
+            total += pipeline(i.slice(low, low + piece));
+        }
+        return total;
+    }, trials, "arena: a pipeline per slice of " + std::to_string(piece));
+}
@@ -0,0 +1,58 @@
+#include <iostream>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+// Print how many elements a second a benchmark went through
+void
+throughput(double milliseconds) {
+    std::cout << "\t" << csize / milliseconds / 1000 << " million elements/sec" << std::endl;
+}
+
+
+int main() {
+    auto input = [](){ return csize; };
+    auto square = [](long x) { return x * x; };
+    auto even = [](long x) { return x % 2 == 0; };
+
+    std::cout << "Comparing Streams & chunked Streams "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    throughput(bench(input, [&](int n) {
+        auto c = from(1L).map(square).take(n);
+    }, trials, "from/map/take"));
+
+    throughput(bench(input, [&](int n) {
+        auto c = chunked_from(1L).map(square).take(n);
+    }, trials, "chunked from/map/take"));
+
+    throughput(bench(input, [&](int n) {
+        auto c = from(1L).map(square).filter(even).take(n);
+    }, trials, "from/map/filter/take"));
+
+    throughput(bench(input, [&](int n) {
+        auto c = chunked_from(1L).map(square).filter(even).take(n);
+    }, trials, "chunked from/map/filter/take"));
+
+    throughput(bench(input, [&](int n) {
+        auto c = zipWith([](long a, long b) { return a + b; }, from(1L), from(2L, 2L)).take(n);
+    }, trials, "zipWith/take"));
+
+    throughput(bench(input, [&](int n) {
+        auto c = zipWith([](long a, long b) { return a + b; },
+            chunked_from(1L), chunked_from(2L, 2L)).take(n);
+    }, trials, "chunked zipWith/take"));
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+#define parts 16
+
+using namespace cpp_collections;
+
+
+int main() {
+    // 'parts' Collections of csize elements each
+    auto input = [](){
+        std::vector<Collection<int>> list;
+        for (int i = 0; i < parts; i++)
+            list.push_back(range(i * csize, (i + 1) * csize));
+        return list;
+    };
+    auto inc = [](int x) {return x+1;};
+
+    std::cout << "Comparing contiguous & chunked concat of " << parts << " Collections "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](std::vector<Collection<int>> l) {
+        auto c = concat(l[0], l[1], l[2], l[3], l[4], l[5], l[6], l[7],
+            l[8], l[9], l[10], l[11], l[12], l[13], l[14], l[15]);
+        return c.size();
+    }, trials, "concat: copy into one Collection");
+
+    bench(input, [&](std::vector<Collection<int>> l) {
+        auto c = concat(ChunkedCollection<int>(l[0]), l[1], l[2], l[3], l[4], l[5], l[6], l[7],
+            l[8], l[9], l[10], l[11], l[12], l[13], l[14], l[15]);
+        return c.size();
+    }, trials, "concat: splice chunks");
+
+    bench(input, [&](std::vector<Collection<int>> l) {
+        ChunkedCollection<int> c;
+        for (const auto& part : l)
+            c = c.append(part);
+        return c.compact().size();
+    }, trials, "append chunks, then compact");
+
+    bench(input, [&](std::vector<Collection<int>> l) {
+        auto c = concat(l[0], l[1], l[2], l[3], l[4], l[5], l[6], l[7],
+            l[8], l[9], l[10], l[11], l[12], l[13], l[14], l[15]);
+        return c.tmap(inc).sum();
+    }, trials, "concat, then tmap & sum");
+
+    bench(input, [&](std::vector<Collection<int>> l) {
+        ChunkedCollection<int> c(l);
+        return c.tmap(inc).sum(detectedThreads);
+    }, trials, "chunked: tmap & sum over chunks");
+}
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+// Compare deduplicating elements drawn from 'cardinality' distinct values
+void
+compare(int cardinality) {
+    random_generator random;
+    std::vector<int> values(csize);
+    for (auto& x : values)
+        x = random(cardinality);
+    std::vector<int> other_values(csize);
+    for (auto& x : other_values)
+        x = random(cardinality);
+    auto other = Collection<int>(other_values);
+
+    auto inputVector = [&](){ return values; };
+    auto input = [&](){ return Collection<int>(values); };
+    volatile int sink = 0;
+
+    std::cout << "Comparing unordered_set & distinct/intersect/diff "
+        << "with size: " << csize
+        << ", cardinality: " << cardinality
+        << ", and trials: " << trials << std::endl;
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::unordered_set<int> seen;
+        std::vector<int> result;
+        for (int x : v)
+            if (seen.insert(x).second)
+                result.push_back(x);
+        sink = result.size();
+    }, trials, "unordered_set distinct");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.distinct().size();
+    }, trials, "distinct");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.distinct(detectedThreads).size();
+    }, trials, "distinct parallel");
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::unordered_set<int> others(other_values.begin(), other_values.end());
+        std::unordered_set<int> seen;
+        std::vector<int> result;
+        for (int x : v)
+            if (others.count(x) && seen.insert(x).second)
+                result.push_back(x);
+        sink = result.size();
+    }, trials, "unordered_set intersect");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.intersect(other).size();
+    }, trials, "intersect");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.diff(other, detectedThreads).size();
+    }, trials, "diff parallel");
+}
+
+
+int main() {
+    compare(1000);
+    compare(csize / 2 + 1);
+}
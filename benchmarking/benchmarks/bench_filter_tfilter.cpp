@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+int main() {
+    random_generator rand_gen;
+    auto rand_input = [&](){
+        std::vector<int> data(csize);
+        for (int i = 0; i < csize; i++)
+            data[i] = rand_gen(100);
+        return data;
+    };
+
+    std::cout << "Comparing filter & tfilter "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    // keep 1%, 50% and 99% of the elements
+    for (int percent : {1, 50, 99}) {
+        auto pred = [=](int x) { return x < percent; };
+        std::string label = " w/ " + std::to_string(percent) + "% kept";
+
+        bench(rand_input, [&](std::vector<int> v) {
+            std::vector<int> out;
+            for (int i = 0; i < int(v.size()); i++)
+                if (pred(v[i]))
+                    out.push_back(v[i]);
+            return out;
+        }, trials, "for loop push_back" + label);
+
+        bench(rand_input, [&](Collection<int> i) {
+            return i.filter(pred);
+        }, trials, "filter: linear filter" + label);
+
+        bench(rand_input, [&](Collection<int> i) {
+            return i.tfilter(pred, 4);
+        }, trials, "tfilter: parallel filter" + label);
+    }
+}
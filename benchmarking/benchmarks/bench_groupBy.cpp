@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+// Compare grouping by keys drawn from 'cardinality' distinct values
+void
+compare(int cardinality) {
+    random_generator random;
+    std::vector<int> keys(csize);
+    for (auto& x : keys)
+        x = random(cardinality);
+
+    auto inputVector = [&](){ return keys; };
+    auto input = [&](){ return Collection<int>(keys); };
+    auto key = [](int x) { return x; };
+    volatile int sink = 0;
+
+    std::cout << "Comparing unordered_map & countBy/reduceByKey/groupBy "
+        << "with size: " << csize
+        << ", cardinality: " << cardinality
+        << ", and trials: " << trials << std::endl;
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::unordered_map<int, int> counts;
+        for (int x : v)
+            counts[x]++;
+        sink = counts.size();
+    }, trials, "unordered_map count");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.countBy(key).size();
+    }, trials, "countBy");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.countBy(key, detectedThreads).size();
+    }, trials, "countBy parallel");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.reduceByKey(key, key, [](int a, int b) { return a + b; }).size();
+    }, trials, "reduceByKey");
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::unordered_map<int, std::vector<int>> groups;
+        for (int x : v)
+            groups[x].push_back(x);
+        sink = groups.size();
+    }, trials, "unordered_map group");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.groupBy(key).size();
+    }, trials, "groupBy");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.groupBy(key, detectedThreads).size();
+    }, trials, "groupBy parallel");
+}
+
+
+int main() {
+    compare(100);
+    compare(csize / 2 + 1);
+}
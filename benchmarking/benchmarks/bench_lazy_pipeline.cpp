@@ -0,0 +1,68 @@
+#include <iostream>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto inputVector = [](){
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
+            v[i] = i;
+        return v;
+    };
+    auto input = [](){ return range(0, csize).materialize(); };
+    auto inputRange = [](){ return range(0, csize); };
+    auto inc = [](int x) {return x+1;};
+    auto odd = [](int x) {return x % 2 == 1;};
+    auto dbl = [](int x) {return x*2;};
+    auto add = [](int x, int y) {return x+y;};
+    // keeps the reductions from being optimized away
+    volatile int sink = 0;
+
+    std::cout << "Comparing eager & lazy map/filter/map/reduceLeft pipelines "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(inputVector, [&](std::vector<int> v) {
+        int sum = 0;
+        for (int i = 0; i < int(v.size()); i++) {
+            int x = inc(v[i]);
+            if (odd(x))
+                sum += dbl(x);
+        }
+        sink = sum;
+    }, trials, "for loop pipeline");
+
+    bench(input, [&](Collection<int> i) {
+        sink = i.map(inc).filter(odd).map(dbl).reduceLeft(add);
+    }, trials, "eager: map/filter/map/reduceLeft");
+
+    bench(input, [&](Collection<int> i) {
+        sink = i.lazy().map(inc).filter(odd).map(dbl).reduceLeft(add);
+    }, trials, "lazy: fused map/filter/map/reduceLeft");
+
+    bench(inputRange, [&](const Range<int>& r) {
+        sink = r.lazy().map(inc).filter(odd).map(dbl).reduceLeft(add);
+    }, trials, "lazy: fused map/filter/map/reduceLeft generating the range");
+
+    bench(input, [&](Collection<int> i) {
+        return i.map(inc).filter(odd).map(dbl);
+    }, trials, "eager: map/filter/map");
+
+    bench(input, [&](Collection<int> i) {
+        return i.lazy().map(inc).filter(odd).map(dbl).collect();
+    }, trials, "lazy: fused map/filter/map/collect");
+}
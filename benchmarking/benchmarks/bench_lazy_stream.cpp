@@ -0,0 +1,50 @@
+#include <iostream>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto input = [](){ return csize; };
+    auto square = [](long x) { return x * x; };
+    auto even = [](long x) { return x % 2 == 0; };
+
+    std::cout << "Comparing a for loop & Streams for from(1).map(sq).filter(even).take(n) "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](int n) {
+        std::vector<long> list(n);
+        long x = 1;
+        for (int i = 0; i < n; x++) {
+            long y = square(x);
+            if (even(y))
+                list[i++] = y;
+        }
+        auto c = Collection<long>(std::move(list));
+    }, trials, "for loop");
+
+    bench(input, [&](int n) {
+        auto c = lazy_from(1L).map(square).filter(even).take(n);
+    }, trials, "LazyStream");
+
+    bench(input, [&](int n) {
+        auto c = chunked_from(1L).map(square).filter(even).take(n);
+    }, trials, "ChunkedStream");
+
+    bench(input, [&](int n) {
+        auto c = from(1L).map(square).filter(even).take(n);
+    }, trials, "Stream");
+}
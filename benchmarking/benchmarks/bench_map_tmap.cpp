@@ -1,14 +1,15 @@
 #include <iostream>
+#include <thread>
 #include <vector>
 
-#include "collections.h"
+#include "../../src/cpp_collections.h"
 #include "benchmark.h"
 
 
 #if defined COLLECTION_SIZE
-#define size COLLECTION_SIZE
+#define csize COLLECTION_SIZE
 #else
-#define size 100
+#define csize 100
 #endif
 
 #define trials 10
@@ -18,31 +19,51 @@
 
 
 using namespace cpp_collections;
+
+// The previous tmap strategy: spawn and join a std::thread per chunk on every
+// call, used as the baseline for the worker pool
+template<typename Function>
+std::vector<int>
+spawn_map(const std::vector<int>& v, Function func, int threads) {
+    std::vector<int> out(v.size());
+    std::vector<std::thread> workers;
+    int chunk = (v.size() + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            for (int i = t * chunk; i < (t + 1) * chunk && i < int(v.size()); i++)
+                out[i] = func(v[i]);
+        }));
+    }
+    for (auto& w : workers)
+        w.join();
+    return out;
+}
+
 int main() {
     auto inputVector = [](){
-        std::vector<int> v(size);
-        for (int i = 0; i < size; i++)
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
             v[i] = i;
         return v;
     };
-    auto input = [](){ return range(0, size); };
+    auto input = [](){ return range(0, csize).materialize(); };
     auto inc = [](int x) {return x+1;};
     random_generator rand_gen;
 
     auto rand_input = [&](){
-        std::vector<int> data(size);
-        for (int i = 0; i < size; i++)
-            data[i] = rand_gen(size);
+        std::vector<int> data(csize);
+        for (int i = 0; i < csize; i++)
+            data[i] = rand_gen(csize);
         return data;
     };
 
     std::cout << "Comparing map & tmap "
-        << "with size: " << size
+        << "with size: " << csize
         << ", and trials: " << trials << std::endl;
 
 
     bench(inputVector, [&](std::vector<int> v) {
-        for (int i = 0; i < size; i++)
+        for (int i = 0; i < csize; i++)
             v[i] = v[i]+1;
         return v;
     }, trials, "for loop iteration");
@@ -55,9 +76,21 @@ int main() {
         return i.tmap(inc, 4);
     }, trials, "tmap: parallel map");
 
+    bench(inputVector, [&](std::vector<int> v) {
+        return spawn_map(v, inc, 4);
+    }, trials, "spawn_map: std::thread per call");
+
     bench(input, [&](Collection<int> i) {
-        return i.pmap(inc);
-    }, trials, "pmap: linear map");
+        return i.map(inc).map(inc).map(inc);
+    }, trials, "map: 3 chained maps");
+
+    bench(input, [&](Collection<int> i) {
+        return i.tmap(inc, 4).tmap(inc, 4).tmap(inc, 4);
+    }, trials, "tmap: 3 chained parallel maps");
+
+    bench(inputVector, [&](std::vector<int> v) {
+        return spawn_map(spawn_map(spawn_map(v, inc, 4), inc, 4), inc, 4);
+    }, trials, "spawn_map: 3 chained std::thread per call maps");
 
 
     bench(rand_input, [&](Collection<int> i) {
@@ -67,8 +100,4 @@ int main() {
     bench(rand_input, [&](Collection<int> i) {
         return i.tmap(inc, 4);
     }, trials, "tmap: parallel map w/ random data");
-
-    bench(rand_input, [&](Collection<int> i) {
-        return i.pmap(inc, 4);
-    }, trials, "pmap: parallel map w/ random data");
 }
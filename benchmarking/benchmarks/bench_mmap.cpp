@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+#define path "bench_mmap.bin"
+
+using namespace cpp_collections;
+
+
+int main() {
+    // write csize int64_t elements to a file, which stays in the page cache
+    range(int64_t(0), int64_t(csize)).map([](int64_t x) { return x; }, path);
+
+    auto input = [](){ return std::string(path); };
+    volatile int64_t sink = 0;
+
+    std::cout << "Comparing reading & mapping a file "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](std::string p) {
+        FILE* file = fopen(p.c_str(), "rb");
+        std::vector<int64_t> v(csize);
+        sink = fread(v.data(), sizeof(int64_t), csize, file);
+        fclose(file);
+        auto c = Collection<int64_t>(std::move(v));
+    }, trials, "fread into a Collection");
+
+    bench(input, [&](std::string p) {
+        auto c = Collection<int64_t>::mmap(p);
+        sink = c.size();
+    }, trials, "mmap a Collection");
+
+    bench(input, [&](std::string p) {
+        FILE* file = fopen(p.c_str(), "rb");
+        std::vector<int64_t> v(csize);
+        sink = fread(v.data(), sizeof(int64_t), csize, file);
+        fclose(file);
+        sink = Collection<int64_t>(std::move(v)).sum();
+    }, trials, "fread into a Collection & sum");
+
+    bench(input, [&](std::string p) {
+        sink = Collection<int64_t>::mmap(p).sum();
+    }, trials, "mmap a Collection & sum");
+
+    bench(input, [&](std::string p) {
+        Collection<int64_t>::mmap(p).tmap([](int64_t x) { return x * 2; }, p + ".out");
+    }, trials, "mmap a Collection & tmap to a file");
+
+    std::remove(path);
+    std::remove(path ".out");
+}
@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
@@ -7,24 +8,25 @@
 
 
 #if defined COLLECTION_SIZE
-#define size COLLECTION_SIZE
+#define csize COLLECTION_SIZE
 #else
-#define size 100
+#define csize 100
 #endif
 
 
 #define trials 10
+#define large 100000000
 
 using namespace cpp_collections;
 
 
 int main() {
     // timing map on a vector of size 100,000
-    auto input = [](){ return size; };
+    auto input = [](){ return csize; };
 
 
-    std::cout << "Comparing range & for loops"
-        << "with size: " << size
+    std::cout << "Comparing range & for loops "
+        << "with size: " << csize
         << ", and trials: " << trials << std::endl;
 
     bench(input, [](int n) {
@@ -32,10 +34,41 @@ int main() {
         for (int i = 0; i < n; i++)
             data[i] = i;
         auto c = data;
-    }, trials, "for loop range of " + std::to_string(size));
+    }, trials, "for loop range of " + std::to_string(csize));
 
     bench(input, [](int i) {
-        auto c = range(i);
-    }, trials, "range of " + std::to_string(size));
-}
+        auto c = range(i).materialize();
+    }, trials, "materialized range of " + std::to_string(csize));
+
+    // summing 1..100M, which used to allocate 800 MB of int64_t
+    auto inputLarge = [](){ return int64_t(large); };
+    auto add = [](int64_t x, int64_t y) { return x + y; };
+    volatile int64_t sink = 0;
+
+    std::cout << "Comparing sums of range(1, " << large + 1 << ") "
+        << "with trials: " << trials << std::endl;
+
+    bench(inputLarge, [&](int64_t n) {
+        int64_t sum = 0;
+        for (int64_t i = 1; i <= n; i++)
+            sum += i;
+        sink = sum;
+    }, trials, "for loop sum");
 
+    bench(inputLarge, [&](int64_t n) {
+        sink = range(int64_t(1), n + 1).reduceLeft(add);
+    }, trials, "reduceLeft generating the range");
+
+    bench(inputLarge, [&](int64_t n) {
+        sink = range(int64_t(1), n + 1).lazy().map([](int64_t x) { return x * 2; }).reduceLeft(add);
+    }, trials, "lazy map & reduceLeft generating the range");
+
+    bench(inputLarge, [&](int64_t n) {
+        sink = range(int64_t(1), n + 1).sum();
+    }, trials, "closed form sum");
+
+    auto inputMaterialized = [](){ return range(int64_t(1), int64_t(large) + 1).materialize(); };
+    bench(inputMaterialized, [&](const Collection<int64_t>& c) {
+        sink = c.sum();
+    }, 1, "SIMD sum of the materialized range");
+}
@@ -1,41 +1,64 @@
 #include <iostream>
+#include <numeric>
+#include <thread>
 #include <vector>
 
-#include "collections.h"
+#include "../../src/cpp_collections.h"
 #include "benchmark.h"
 
 #if defined COLLECTION_SIZE
-#define size COLLECTION_SIZE
+#define csize COLLECTION_SIZE
 #else
-#define size 100
+#define csize 100
 #endif
 
 #define trials 10
 
 using namespace cpp_collections;
 
+// The previous treduce strategy: spawn and join a std::thread per chunk on
+// every call, used as the baseline for the worker pool
+template<typename Function>
+int
+spawn_reduce(const std::vector<int>& v, Function func, int threads) {
+    std::vector<int> results(threads);
+    std::vector<std::thread> workers;
+    int chunk = (v.size() + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            int val = 0;
+            for (int i = t * chunk; i < (t + 1) * chunk && i < int(v.size()); i++)
+                val = func(val, v[i]);
+            results[t] = val;
+        }));
+    }
+    for (auto& w : workers)
+        w.join();
+    return std::accumulate(results.begin(), results.end(), 0, func);
+}
+
 
 int main() {
     // timing reduce on a vector of size 100,000
     auto inputVector = [](){
-        std::vector<int> v(size);
-        for (int i = 0; i < size; i++)
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
             v[i] = i;
         return v;
     };
-    auto input = [](){ return range(0, size); };
+    auto input = [](){ return range(0, csize).materialize(); };
     auto add = [](int x, int y) {return x+y;};
     random_generator rand_gen;
 
     auto rand_input = [&](){
-        std::vector<int> data(size);
-        for (int i = 0; i < size; i++)
-            data[i] = rand_gen(size);
+        std::vector<int> data(csize);
+        for (int i = 0; i < csize; i++)
+            data[i] = rand_gen(csize);
         return data;
     };
 
     std::cout << "Comparing reduceLeft & treduce"
-        << "with size: " << size
+        << "with size: " << csize
         << ", and trials: " << trials << std::endl;
 
     bench(inputVector, [](std::vector<int> v){
@@ -47,13 +70,21 @@ int main() {
         return i.reduceLeft(add);
     }, trials, "reduceLeft: linear reduceLeft");
 
+    bench(input, [&](Collection<int> i){
+        return i.reduceLeft(std::function<int(int, int)>(add));
+    }, trials, "reduceLeft: through std::function");
+
+    bench(input, [&](Collection<int> i){
+        return i.reduceLeft(std::plus<int>());
+    }, trials, "reduceLeft: std::plus");
+
     bench(input, [&](Collection<int> i){
         return i.treduce(add, 4);
     }, trials, "treduce: parallel reduce");
 
-    bench(input, [&](Collection<int> i){
-        return i.preduce(add, 4);
-    }, trials, "preduce: parallel reduce");
+    bench(inputVector, [&](std::vector<int> v){
+        return spawn_reduce(v, add, 4);
+    }, trials, "spawn_reduce: std::thread per call");
 
 
     bench(rand_input, [&](std::vector<int> v){
@@ -68,8 +99,4 @@ int main() {
     bench(rand_input, [&](Collection<int> i){
         return i.treduce(add, 4);
     }, trials, "treduce: parallel reduce w/ random data");
-
-    bench(rand_input, [&](Collection<int> i){
-        return i.preduce(add, 4);
-    }, trials, "preduce: parallel reduce w/ random data");
 }
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto inputVector = [](){
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
+            v[i] = i;
+        return v;
+    };
+    auto input = [](){ return range(0, csize).materialize(); };
+    auto add = [](int x, int y) {return x+y;};
+
+    std::cout << "Comparing scanLeft & tscanLeft "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(inputVector, [](const std::vector<int>& v) {
+        std::vector<int> out(v.size() + 1);
+        for (int i = 0; i < int(v.size()); i++)
+            out[i + 1] = out[i] + v[i];
+        return out;
+    }, trials, "for loop running total");
+
+    bench(input, [&](Collection<int> i) {
+        return i.scanLeft(add, 0);
+    }, trials, "scanLeft: linear scan");
+
+    // the pool and the calling thread give detectedThreads threads, so
+    // asking for more measures the same thing again
+    for (int threads : {1, 2, 4, 8, 16}) {
+        if (threads > detectedThreads)
+            break;
+        bench(input, [&](Collection<int> i) {
+            return i.tscanLeft(add, 0, threads);
+        }, trials, "tscanLeft: parallel scan w/ " + std::to_string(threads) + " threads");
+    }
+
+    bench(input, [&](Collection<int> i) {
+        return i.scanRight(add, 0);
+    }, trials, "scanRight: linear scan");
+
+    bench(input, [&](Collection<int> i) {
+        return i.tscanRight(add, 0, detectedThreads);
+    }, trials, "tscanRight: parallel scan w/ " + std::to_string(detectedThreads) + " threads");
+}
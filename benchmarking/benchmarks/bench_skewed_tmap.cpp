@@ -0,0 +1,73 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+// Static partitioning: one std::thread per equal-sized chunk, as tmap did
+// before it ran on the work-stealing pool
+template<typename Function>
+std::vector<int>
+static_map(const std::vector<int>& v, Function func, int threads) {
+    std::vector<int> out(v.size());
+    std::vector<std::thread> workers;
+    int chunk = (v.size() + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        workers.push_back(std::thread([&, t]() {
+            for (int i = t * chunk; i < (t + 1) * chunk && i < int(v.size()); i++)
+                out[i] = func(v[i]);
+        }));
+    }
+    for (auto& w : workers)
+        w.join();
+    return out;
+}
+
+
+int main() {
+    auto inputVector = [](){
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
+            v[i] = i;
+        return v;
+    };
+    auto input = [](){ return range(0, csize).materialize(); };
+
+    // the first eighth of the elements costs ~1000x more than the rest, so
+    // the chunk that holds them dominates a static split
+    auto skewed = [](int x) {
+        int iterations = (x < csize / 8) ? 1000 : 1;
+        volatile int acc = x;
+        for (int i = 0; i < iterations; i++)
+            acc = acc * 31 + i;
+        return static_cast<int>(acc);
+    };
+
+    std::cout << "Comparing static and work-stealing tmap on skewed work "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](Collection<int> i) {
+        return i.map(skewed);
+    }, trials, "map: linear map");
+
+    bench(inputVector, [&](std::vector<int> v) {
+        return static_map(v, skewed, 4);
+    }, trials, "static_map: 4 static chunks");
+
+    bench(input, [&](Collection<int> i) {
+        return i.tmap(skewed, 4);
+    }, trials, "tmap: work-stealing parallel map");
+}
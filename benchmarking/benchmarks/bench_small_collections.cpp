@@ -0,0 +1,74 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#define trials 10
+#define repeats 100000
+
+// count every heap allocation made by the process
+std::atomic<long> allocations(0);
+
+void*
+operator new(std::size_t bytes) {
+    allocations++;
+    if (void* p = std::malloc(bytes))
+        return p;
+    throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto inc = [](int x) {return x+1;};
+    auto odd = [](int x) {return x % 2 == 1;};
+    auto add = [](int x, int y) {return x+y;};
+
+    std::cout << "Comparing std::vector & Collection map/filter/sum pipelines on small inputs "
+        << "with " << repeats << " pipelines per trial, and trials: " << trials
+        << " (inline capacity for int: " << inline_capacity<int>::value << ")" << std::endl;
+
+    volatile int sink = 0;
+    int sizes[] = {1, 2, 4, 8, 16, 32, 64};
+    for (int n : sizes) {
+        auto input = [n]() { return n; };
+
+        long before = allocations;
+        bench(input, [&](int size) {
+            for (int r = 0; r < repeats; r++) {
+                std::vector<int> v(size);
+                for (int i = 0; i < size; i++)
+                    v[i] = inc(i + r);
+                std::vector<int> kept;
+                for (int i = 0; i < size; i++)
+                    if (odd(v[i]))
+                        kept.push_back(v[i]);
+                int sum = 0;
+                for (int x : kept)
+                    sum += x;
+                sink = sum;
+            }
+        }, trials, "std::vector with size: " + std::to_string(n));
+        std::cout << "\t\t" << double(allocations - before) / (trials * repeats)
+            << " allocations per pipeline" << std::endl;
+
+        before = allocations;
+        bench(input, [&](int size) {
+            for (int r = 0; r < repeats; r++)
+                sink = range(r, r + size).map(inc).filter(odd).foldLeft(add, 0);
+        }, trials, "Collection with size: " + std::to_string(n));
+        std::cout << "\t\t" << double(allocations - before) / (trials * repeats)
+            << " allocations per pipeline" << std::endl;
+    }
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+int main() {
+    random_generator random;
+    std::vector<int> numbers(csize);
+    for (auto& x : numbers)
+        x = random(1 << 30) - (1 << 29);
+
+    auto inputVector = [&](){ return numbers; };
+    auto input = [&](){ return Collection<int>(numbers); };
+    volatile int sink = 0;
+
+    std::cout << "Comparing std::sort & sort "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::sort(v.begin(), v.end());
+        sink = v[0];
+    }, trials, "std::sort");
+
+    bench(inputVector, [&](std::vector<int> v) {
+        std::stable_sort(v.begin(), v.end());
+        sink = v[0];
+    }, trials, "std::stable_sort");
+
+    bench(input, [&](Collection<int> c) {
+        sink = std::move(c).sort()[0];
+    }, trials, "sort (radix)");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.sortBy([](int x) { return -x; })[0];
+    }, trials, "sortBy (radix)");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.sortBy([](int x) { return std::make_pair(x % 1000, x); })[0];
+    }, trials, "sortBy (merge)");
+
+    bench(input, [&](Collection<int> c) {
+        sink = c.stableSortBy([](int x) { return std::make_pair(x % 1000, 0); })[0];
+    }, trials, "stableSortBy (merge)");
+}
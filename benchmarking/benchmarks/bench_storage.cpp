@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <tuple>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+#define path "bench_storage.bin"
+
+using namespace cpp_collections;
+
+
+int main() {
+    auto input = [](){
+        return range(0, csize).map([](int x) { return x * 0.25; });
+    };
+    auto prices = input();
+    auto ids = range(0, csize).materialize();
+    volatile double sink = 0;
+
+    std::cout << "Comparing text output & binary save/load "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](Collection<double> c) {
+        std::ofstream file(path);
+        file << c;
+    }, 1, "operator<< to a file");
+
+    bench(input, [&](Collection<double> c) {
+        c.save(path);
+    }, trials, "save");
+
+    prices.save(path);
+    bench(input, [&](Collection<double>) {
+        sink = Collection<double>::load(path).size();
+    }, trials, "load");
+
+    bench(input, [&](Collection<double>) {
+        sink = Collection<double>::load(path, true).size();
+    }, trials, "load & verify checksums");
+
+    bench(input, [&](Collection<double>) {
+        sink = Collection<double>::load(path).sum();
+    }, trials, "load & sum");
+
+    bench(input, [&](Collection<double>) {
+        zip(ids, prices).save(path);
+    }, trials, "save a ZippedView");
+
+    bench(input, [&](Collection<double>) {
+        sink = ZippedView<int, double>::load(path).size();
+    }, trials, "load a ZippedView");
+
+    std::remove(path);
+}
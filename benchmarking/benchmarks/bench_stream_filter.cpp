@@ -0,0 +1,52 @@
+#include <iostream>
+#include <sys/resource.h>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+// Return the peak resident memory of the process in megabytes
+long
+peak_megabytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+
+int main() {
+    // the number of matches taken, each a million elements apart
+    auto input = [](){ return csize; };
+    volatile long sink = 0;
+
+    std::cout << "Comparing a loop & filtering 1 in 1000000 elements of from(0) "
+        << "with matches: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(input, [&](int n) {
+        long last = 0;
+        int found = 0;
+        for (long x = 0; found < n; x++)
+            if (x % 1000000 == 999999) {
+                last = x;
+                found++;
+            }
+        sink = last;
+    }, trials, "for loop");
+
+    bench(input, [&](int n) {
+        sink = from(0L).filter([](long x) { return x % 1000000 == 999999; }).take(n).last();
+    }, trials, "Stream filter");
+    std::cout << "\t" << peak_megabytes() << " MB peak resident memory" << std::endl;
+}
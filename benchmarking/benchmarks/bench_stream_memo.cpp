@@ -0,0 +1,62 @@
+#include <cmath>
+#include <iostream>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+
+long calls = 0;
+
+// A generator step that costs about as much as a few hundred multiplies
+double
+step(double x) {
+    calls++;
+    for (int i = 0; i < 100; i++)
+        x = std::sqrt(x * x + 1.0);
+    return x;
+}
+
+
+int main() {
+    auto input = [](){ return csize; };
+    volatile double sink = 0;
+
+    std::cout << "Comparing traversing a Stream twice "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    // every traversal of a fresh Stream runs the generator again, which is
+    // what traversing the same Stream twice cost before tails were memoized
+    calls = 0;
+    bench(input, [&](int n) {
+        sink = iterate(1.0, step).take(n).last();
+        sink = iterate(1.0, step).take(n).last();
+    }, trials, "two Streams");
+    std::cout << "\t" << calls / trials << " generator calls per trial" << std::endl;
+
+    calls = 0;
+    bench(input, [&](int n) {
+        auto stream = iterate(1.0, step);
+        sink = stream.take(n).last();
+        sink = stream.take(n).last();
+    }, trials, "one Stream traversed twice");
+    std::cout << "\t" << calls / trials << " generator calls per trial" << std::endl;
+
+    calls = 0;
+    bench(input, [&](int n) {
+        auto stream = iterate(1.0, step);
+        sink = zipWith([](double a, double b) { return a - b; }, stream, stream).take(n).last();
+    }, trials, "zipWith of a Stream with itself");
+    std::cout << "\t" << calls / trials << " generator calls per trial" << std::endl;
+}
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "../../src/cpp_collections.h"
+#include "benchmark.h"
+
+
+#if defined COLLECTION_SIZE
+#define csize COLLECTION_SIZE
+#else
+#define csize 100
+#endif
+
+#define trials 10
+
+using namespace cpp_collections;
+
+// Print the throughput of a benchmark that read every element once
+void
+throughput(double milliseconds, std::size_t element_size) {
+    double bytes = double(csize) * element_size;
+    std::cout << "\t\t" << bytes / (milliseconds * 1e6) << " GB/s" << std::endl;
+}
+
+
+int main() {
+    auto inputVector = [](){
+        std::vector<int> v(csize);
+        for (int i = 0; i < csize; i++)
+            v[i] = i;
+        return v;
+    };
+    auto input = [](){ return range(0, csize).materialize(); };
+    auto inputDouble = [](){ return range(0.0, double(csize)).materialize(); };
+    auto add = [](int x, int y) {return x+y;};
+    volatile int sink = 0;
+
+    std::cout << "Comparing accumulate & SIMD sum/min/max "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    throughput(bench(inputVector, [&](std::vector<int> v) {
+        sink = std::accumulate(v.begin(), v.end(), 0,
+            [](const int& sum, int i) { return sum + i; });
+    }, trials, "accumulate"), sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.reduceLeft(add);
+    }, trials, "reduceLeft"), sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.sum();
+    }, trials, "sum: SIMD kernel level " + std::to_string(simd_level())), sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.sum(detectedThreads);
+    }, trials, "sum: SIMD kernel on " + std::to_string(detectedThreads) + " threads"), sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.min() + i.max();
+    }, trials, "min + max: two passes"), 2 * sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.minmax().first;
+    }, trials, "minmax: one pass"), sizeof(int));
+
+    throughput(bench(input, [&](Collection<int> i) {
+        sink = i.count([](int x) { return x % 2 == 0; });
+    }, trials, "count"), sizeof(int));
+
+    throughput(bench(inputDouble, [&](Collection<double> i) {
+        sink = i.sum();
+    }, trials, "sum: double SIMD kernel"), sizeof(double));
+}
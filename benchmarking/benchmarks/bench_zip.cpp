@@ -58,5 +58,30 @@ int main() {
     bench(coll_input, [](std::tuple<Collection<int>,Collection<int>,Collection<int>> t) {
         auto c = zip(std::get<0>(t),std::get<1>(t),std::get<2>(t));
     }, trials, "zip of " + std::to_string(csize) + " with random data");
+
+    bench(coll_input, [](std::tuple<Collection<int>,Collection<int>,Collection<int>> t) {
+        auto c = zip(std::get<0>(t),std::get<1>(t),std::get<2>(t)).collect();
+    }, trials, "zip of " + std::to_string(csize) + " collected into tuples");
+
+    std::cout << "Comparing a hand-rolled loop & zipWith "
+        << "with size: " << csize
+        << ", and trials: " << trials << std::endl;
+
+    bench(vec_input, [](std::tuple<std::vector<int>,std::vector<int>,std::vector<int>> t) {
+        int dsize = std::min({std::get<0>(t).size(),std::get<1>(t).size(),std::get<2>(t).size()});
+        std::vector<int> data(dsize);
+        for (int i = 0; i < dsize; i++)
+            data[i] = std::get<0>(t)[i] + std::get<2>(t)[i];
+    }, trials, "loop over 2 of 3 vectors of " + std::to_string(csize));
+
+    bench(coll_input, [](std::tuple<Collection<int>,Collection<int>,Collection<int>> t) {
+        auto c = zip(std::get<0>(t),std::get<1>(t),std::get<2>(t))
+            .map([](int x, int, int z) { return x + z; });
+    }, trials, "zip & map over 2 of 3 columns of " + std::to_string(csize));
+
+    bench(coll_input, [](std::tuple<Collection<int>,Collection<int>,Collection<int>> t) {
+        auto c = zipWith([](int x, int, int z) { return x + z; },
+            std::get<0>(t),std::get<1>(t),std::get<2>(t));
+    }, trials, "zipWith over 2 of 3 columns of " + std::to_string(csize));
 }
 
@@ -23,11 +23,12 @@ public:
 // f: a function that is being benchmarked
 // trials: the number of trials to run
 // name: a short name of the test being run
+// Returns the average time of a trial in milliseconds.
 template<typename Gen, typename Func>
-void
+double
 bench(Gen g, Func f, int trials, std::string name){
     typedef std::chrono::duration<double, std::milli> time;
-    time total;
+    time total(0);
 
     for (int i = 0; i < trials; i++) {
         auto input = g();
@@ -42,6 +43,7 @@ bench(Gen g, Func f, int trials, std::string name){
     std::cout << "\t" << std::setprecision(5) << total.count()/trials << " milliseconds | ";
     std::cout << name;
     std::cout << " | " << trials << " trials" << std::endl;
+    return total.count()/trials;
 };
 
 #endif
@@ -0,0 +1,164 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace cpp_collections {
+
+    // --------------------------
+    // ARENAS
+    // --------------------------
+
+    // A monotonic bump allocator. Memory is handed out from large blocks and
+    // never freed one allocation at a time; release() makes all of it
+    // available again at once while keeping the blocks for reuse.
+    class Arena {
+    private:
+        std::vector<std::unique_ptr<char[]>> Blocks;
+        std::vector<std::size_t> Sizes;
+        std::size_t BlockSize;
+        // the block being allocated from, and the offset of its free space
+        int Current;
+        std::size_t Used;
+
+    public:
+
+        // Start an arena that allocates blocks of at least 'block_size' bytes
+        Arena(std::size_t block_size=1 << 20)
+            : BlockSize(block_size), Current(-1), Used(0) {};
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Return 'bytes' bytes aligned to 'align'
+        void*
+        allocate(std::size_t bytes, std::size_t align);
+
+        // Make all of the memory available again, invalidating everything
+        // that was allocated from the arena
+        void
+        release() {
+            Current = Blocks.empty() ? -1 : 0;
+            Used = 0;
+        };
+
+        // Return the number of bytes held in blocks
+        std::size_t
+        capacity() const {
+            std::size_t total = 0;
+            for (auto size : Sizes)
+                total += size;
+            return total;
+        };
+
+        // Return the arena that Collections built on the calling thread
+        // allocate from, if any
+        static Arena*&
+        current() {
+            static thread_local Arena* arena = nullptr;
+            return arena;
+        };
+    };
+
+    // Return 'bytes' bytes aligned to 'align'
+    inline void*
+    Arena::allocate(std::size_t bytes, std::size_t align) {
+        while (true) {
+            if (Current >= 0) {
+                char* next = Blocks[Current].get() + Used;
+                std::size_t padding = (align - reinterpret_cast<std::size_t>(next) % align) % align;
+                if (Used + padding + bytes <= Sizes[Current]) {
+                    Used += padding + bytes;
+                    return next + padding;
+                }
+            }
+            // move on to the next kept block, or add one large enough
+            if (Current + 1 == int(Blocks.size())) {
+                std::size_t size = std::max(BlockSize, bytes + align);
+                Blocks.push_back(std::unique_ptr<char[]>(new char[size]));
+                Sizes.push_back(size);
+            }
+            Current++;
+            Used = 0;
+        }
+    }
+
+    // Make an arena the one that Collections built on the calling thread
+    // allocate their elements from, for as long as the ScopedArena lives.
+    // The arena is released on destruction, so every Collection built in the
+    // scope must be gone by then; keep a result by calling materialize() on
+    // it, which always copies onto the heap.
+    class ScopedArena {
+    private:
+        std::unique_ptr<Arena> Owned;
+        Arena& Active;
+        Arena* Previous;
+
+    public:
+
+        // Allocate from a new arena with blocks of at least 'block_size' bytes
+        ScopedArena(std::size_t block_size=1 << 20)
+            : Owned(new Arena(block_size)), Active(*Owned), Previous(Arena::current()) {
+            Arena::current() = &Active;
+        };
+
+        // Allocate from an existing arena, whose blocks are kept for reuse
+        ScopedArena(Arena& arena) : Active(arena), Previous(Arena::current()) {
+            Arena::current() = &Active;
+        };
+
+        ~ScopedArena() {
+            Arena::current() = Previous;
+            Active.release();
+        };
+
+        ScopedArena(const ScopedArena&) = delete;
+        ScopedArena& operator=(const ScopedArena&) = delete;
+    };
+
+    // An allocator that takes memory from the calling thread's current arena
+    // when it is constructed, and from the heap otherwise. Memory from an
+    // arena is only given back when the arena is released.
+    template<typename T>
+    struct ArenaAllocator {
+        using value_type = T;
+
+        Arena* Source;
+
+        ArenaAllocator() : Source(Arena::current()) {};
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : Source(other.Source) {};
+
+        T*
+        allocate(std::size_t n) {
+            if (Source)
+                return static_cast<T*>(Source->allocate(n * sizeof(T), alignof(T)));
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        };
+
+        void
+        deallocate(T* p, std::size_t) {
+            if (!Source)
+                ::operator delete(p);
+        };
+    };
+
+    template<typename T, typename U>
+    bool
+    operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+        return a.Source == b.Source;
+    }
+
+    template<typename T, typename U>
+    bool
+    operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+        return a.Source != b.Source;
+    }
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef BUFFER_H
+#define BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "arena.h"
+
+namespace cpp_collections {
+
+    // --------------------------
+    // SHARED BUFFERS
+    // --------------------------
+
+    // A Collection keeps its elements in a buffer that is shared with every
+    // view sliced from it. The returned pointer owns the whole allocation but
+    // points at its first element, so a view only has to copy it and keep its
+    // own begin pointer and length.
+
+    // The number of elements a Collection keeps inside itself instead of in
+    // a shared buffer, so that small Collections never allocate. Only types
+    // that can be copied bytewise qualify; specialize this to change the
+    // threshold for a type.
+    template<typename T>
+    struct inline_capacity : std::integral_constant<int,
+        (std::is_trivially_copyable<T>::value &&
+         alignof(T) <= alignof(std::max_align_t)) ? int(64 / sizeof(T)) : 0> {};
+
+    // Room for N elements inside a Collection
+    template<typename T, int N = inline_capacity<T>::value>
+    struct InlineBuffer {
+        alignas(T) char Bytes[N * sizeof(T)];
+
+        T*
+        data() {
+            return reinterpret_cast<T*>(Bytes);
+        };
+    };
+
+    template<typename T>
+    struct InlineBuffer<T, 0> {
+        T*
+        data() {
+            return nullptr;
+        };
+    };
+
+    // The vector that Collections build their elements in, which allocates
+    // from the calling thread's current arena if there is one
+    template<typename T>
+    using buffer_vector = std::vector<T, ArenaAllocator<T>>;
+
+    // Take over the storage of a std::vector, allocating the shared owner
+    // with the vector's own allocator
+    template<typename T, typename Allocator>
+    std::shared_ptr<T>
+    make_buffer(std::vector<T, Allocator>&& list) {
+        auto owner = std::allocate_shared<std::vector<T, Allocator>>(
+            list.get_allocator(), std::move(list));
+        return std::shared_ptr<T>(owner, owner->data());
+    }
+
+    // std::vector<bool> packs its elements into bits, so they are copied into
+    // a plain array instead
+    template<typename Allocator>
+    std::shared_ptr<bool>
+    make_buffer(std::vector<bool, Allocator>&& list) {
+        std::shared_ptr<bool> buffer(new bool[list.size()], std::default_delete<bool[]>());
+        for (std::size_t i = 0; i < list.size(); i++)
+            buffer.get()[i] = list[i];
+        return buffer;
+    }
+}
+
+#endif
@@ -0,0 +1,330 @@
+#ifndef CHUNKED_H
+#define CHUNKED_H
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "collections.h"
+
+namespace cpp_collections {
+
+    // A Collection stored as a list of chunks rather than one contiguous
+    // buffer. Every chunk is a Collection view, so splitting a Collection into
+    // chunks, concatenating and appending only splice views together and
+    // never copy an element. Operations run chunk by chunk, and the parallel
+    // ones hand whole chunks to the shared worker pool.
+    template<typename T>
+    class ChunkedCollection {
+    private:
+        std::vector<Collection<T>> Chunks;
+        // the index of the first element of every chunk, followed by the
+        // total number of elements
+        std::vector<long> Offsets;
+
+        // Add a chunk to the end, dropping empty ones
+        void
+        add(const Collection<T>& chunk) {
+            if (chunk.Length == 0)
+                return;
+            Chunks.push_back(chunk);
+            Offsets.push_back(Offsets.back() + chunk.Length);
+        };
+
+        // Add every chunk of 'other' to the end
+        void
+        add(const ChunkedCollection<T>& other) {
+            for (const auto& chunk : other.Chunks)
+                add(chunk);
+        };
+
+        // Add the chunks of every argument to the end
+        void
+        add_all() {};
+
+        template<typename First, typename ...Rest>
+        void
+        add_all(const First& first, const Rest&... rest) {
+            add(first);
+            add_all(rest...);
+        };
+
+        template<typename U, typename ...Collections>
+        friend ChunkedCollection<U>
+        concat(const ChunkedCollection<U>& original, const Collections&... other_list);
+
+    public:
+
+        // construct an empty ChunkedCollection
+        ChunkedCollection<T>() : Offsets(1, 0) {};
+
+        // Split a Collection into chunks of 'segment' elements, which share
+        // its buffer
+        ChunkedCollection<T>(const Collection<T>& c, int segment=1 << 16)
+            : Offsets(1, 0) {
+            for (int low = 0; low < c.Length; low += segment)
+                add(c.slice(low, std::min(low + segment, c.Length)));
+        };
+
+        // Use each of the Collections as a chunk
+        ChunkedCollection<T>(const std::vector<Collection<T>>& chunks)
+            : Offsets(1, 0) {
+            for (const auto& chunk : chunks)
+                add(chunk);
+        };
+
+        // Overload the [] operator, which finds the chunk by binary search
+        T
+        operator[] (const long index) const {
+            int chunk = std::upper_bound(Offsets.begin(), Offsets.end(), index) - Offsets.begin() - 1;
+            return Chunks[chunk].Data[index - Offsets[chunk]];
+        };
+
+        // Return the number of elements
+        long
+        size() const {
+            return Offsets.back();
+        };
+
+        // Return the number of chunks
+        int
+        chunk_count() const {
+            return Chunks.size();
+        };
+
+        // Return the chunk at position 'index'
+        const Collection<T>&
+        chunk(int index) const {
+            return Chunks[index];
+        };
+
+        // Return the elements followed by those of 'other', without copying
+        // any of them
+        ChunkedCollection<T>
+        append(const Collection<T>& other) const {
+            ChunkedCollection<T> result(*this);
+            result.add(other);
+            return result;
+        };
+
+        // Return the elements followed by those of 'other', without copying
+        // any of them
+        ChunkedCollection<T>
+        append(const ChunkedCollection<T>& other) const {
+            ChunkedCollection<T> result(*this);
+            result.add(other);
+            return result;
+        };
+
+        // Return the elements as one contiguous Collection, throwing
+        // std::length_error if there are more than a Collection can hold
+        Collection<T>
+        compact() const;
+
+        // Apply a function to all the elements
+        template<typename Function>
+        void
+        each(Function func) const;
+
+        // Return the result of transforming every element, with the same
+        // chunks
+        template<typename Function>
+        ChunkedCollection<typename std::result_of<Function(T)>::type>
+        map(Function func) const;
+
+        // An alternative implementation of map that transforms the chunks on
+        // the shared worker pool
+        template<typename Function>
+        ChunkedCollection<typename std::result_of<Function(T)>::type>
+        tmap(Function func, int threads=detectedThreads) const;
+
+        // Return the elements that pass a predicate function
+        template<typename Function>
+        ChunkedCollection<T>
+        filter(Function func) const;
+
+        // Return the result of the application of the same binary operator on
+        // adjacent pairs of elements, starting from the left
+        template<typename Function>
+        T
+        reduceLeft(Function func) const;
+
+        // An alternative implementation of reduce that reduces the chunks on
+        // the shared worker pool (note that the function passed to treduce
+        // must be commutative to achieve accurate result)
+        template<typename Function>
+        T
+        treduce(Function func, int threads=detectedThreads) const;
+
+        // Return the result of the application of the same binary operator on
+        // all elements as well as an initial value, starting from the left
+        template<typename Function, typename U>
+        typename std::result_of<Function(U, T)>::type
+        foldLeft(Function func, U init) const;
+
+        // Return the sum of the elements, using the vector kernels of
+        // Collection::sum on every chunk
+        T
+        sum(int threads=1) const;
+    };
+
+    // Return the elements as one contiguous Collection
+    template<typename T>
+    Collection<T>
+    ChunkedCollection<T>::compact() const {
+        if (size() > INT_MAX)
+            throw std::length_error("cannot compact " + std::to_string(size()) +
+                " elements into one Collection");
+        Collection<T> result(static_cast<int>(size()));
+        for (int i = 0; i < chunk_count(); i++)
+            std::copy(Chunks[i].Data, Chunks[i].Data + Chunks[i].Length,
+                result.Data + Offsets[i]);
+        return result;
+    }
+
+    // Apply a function to all the elements
+    template<typename T>
+    template<typename Function>
+    void
+    ChunkedCollection<T>::each(Function func) const {
+        for (const auto& chunk : Chunks)
+            for (int i = 0; i < chunk.Length; i++)
+                func(static_cast<const T&>(chunk.Data[i]));
+    }
+
+    // Return the result of transforming every element, with the same chunks
+    template<typename T>
+    template<typename Function>
+    ChunkedCollection<typename std::result_of<Function(T)>::type>
+    ChunkedCollection<T>::map(Function func) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        std::vector<Collection<return_type>> list(Chunks.size());
+        for (int i = 0; i < chunk_count(); i++)
+            list[i] = Chunks[i].map(func);
+        return ChunkedCollection<return_type>(list);
+    }
+
+    // An alternative implementation of map that transforms the chunks on the
+    // shared worker pool
+    template<typename T>
+    template<typename Function>
+    ChunkedCollection<typename std::result_of<Function(T)>::type>
+    ChunkedCollection<T>::tmap(Function func, int threads) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        std::vector<Collection<return_type>> list(Chunks.size());
+        thread_pool().parallel_for(0, Chunks.size(),
+            parallel_chunks(Chunks.size(), threads), threads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    list[i] = Chunks[i].map(func);
+            });
+        return ChunkedCollection<return_type>(list);
+    }
+
+    // Return the elements that pass a predicate function
+    template<typename T>
+    template<typename Function>
+    ChunkedCollection<T>
+    ChunkedCollection<T>::filter(Function func) const {
+        std::vector<Collection<T>> list(Chunks.size());
+        for (int i = 0; i < chunk_count(); i++)
+            list[i] = Chunks[i].filter(func);
+        return ChunkedCollection<T>(list);
+    }
+
+    // Return the result of the application of the same binary operator on
+    // adjacent pairs of elements, starting from the left
+    template<typename T>
+    template<typename Function>
+    T
+    ChunkedCollection<T>::reduceLeft(Function func) const {
+        if (Chunks.empty())
+            throw std::length_error("reduceLeft of an empty ChunkedCollection");
+        T val = Chunks[0].Data[0];
+        for (int i = 1; i < Chunks[0].Length; i++)
+            val = func(val, Chunks[0].Data[i]);
+        for (int c = 1; c < chunk_count(); c++)
+            for (int i = 0; i < Chunks[c].Length; i++)
+                val = func(val, Chunks[c].Data[i]);
+        return val;
+    }
+
+    // An alternative implementation of reduce that reduces the chunks on the
+    // shared worker pool
+    template<typename T>
+    template<typename Function>
+    T
+    ChunkedCollection<T>::treduce(Function func, int threads) const {
+        if (Chunks.empty())
+            throw std::length_error("treduce of an empty ChunkedCollection");
+        std::vector<T> results(Chunks.size());
+        thread_pool().parallel_for(0, Chunks.size(),
+            parallel_chunks(Chunks.size(), threads), threads,
+            [&](int, int begin, int end) {
+                for (int c = begin; c < end; c++) {
+                    T val = Chunks[c].Data[0];
+                    for (int i = 1; i < Chunks[c].Length; i++)
+                        val = func(val, Chunks[c].Data[i]);
+                    results[c] = val;
+                }
+            });
+
+        T val = results[0];
+        for (int i = 1; i < chunk_count(); i++)
+            val = func(val, results[i]);
+        return val;
+    }
+
+    // Return the result of the application of the same binary operator on all
+    // elements as well as an initial value, starting from the left
+    template<typename T>
+    template<typename Function, typename U>
+    typename std::result_of<Function(U, T)>::type
+    ChunkedCollection<T>::foldLeft(Function func, U init) const {
+        using return_type = typename std::result_of<Function(U, T)>::type;
+        static_assert(std::is_same<return_type, U>::value,
+            "Fold fn must return the same type as the initial value");
+
+        return_type val = init;
+        for (const auto& chunk : Chunks)
+            for (int i = 0; i < chunk.Length; i++)
+                val = func(val, chunk.Data[i]);
+        return val;
+    }
+
+    // Return the sum of the elements, using the vector kernels of
+    // Collection::sum on every chunk
+    template<typename T>
+    T
+    ChunkedCollection<T>::sum(int threads) const {
+        std::vector<T> results(Chunks.size(), T());
+        thread_pool().parallel_for(0, Chunks.size(),
+            threads <= 1 ? 1 : parallel_chunks(Chunks.size(), threads), threads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    results[i] = Chunks[i].sum();
+            });
+
+        T val = T();
+        for (const auto& result : results)
+            val += result;
+        return val;
+    }
+
+    // Concatenate an arbitrary number of ChunkedCollections or Collections by
+    // splicing their chunks, without copying any elements
+    template<typename T, typename ...Collections>
+    ChunkedCollection<T>
+    concat(const ChunkedCollection<T>& original, const Collections&... other_list) {
+        ChunkedCollection<T> result(original);
+        result.add_all(other_list...);
+        return result;
+    }
+}
+
+#endif
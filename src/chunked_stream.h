@@ -0,0 +1,289 @@
+#ifndef CHUNKED_STREAM_H
+#define CHUNKED_STREAM_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "collections.h"
+#include "streams.h"
+
+namespace cpp_collections {
+
+    // The number of elements the chunked Stream sources produce per block,
+    // unless they are given another positive block size
+    const int stream_block = 1024;
+
+    // A Stream whose generators produce a block of elements at a time. Every
+    // block is a Collection, so map, filter and zipWith run over whole blocks
+    // in loops the compiler can vectorize, and the Stream node, generator and
+    // shared tail that a Stream allocates per element are only allocated per
+    // block. The blocks are memoized like the tails of any Stream.
+    template<typename T>
+    class ChunkedStream {
+    private:
+        // never holds an empty block
+        Stream<Collection<T>> Blocks;
+
+    public:
+
+        // Use each Collection of a Stream as a block, skipping empty ones
+        ChunkedStream<T>(Stream<Collection<T>> blocks)
+            : Blocks(std::move(blocks).filter([](Collection<T> block) {
+                return block.size() > 0;
+            })) {};
+
+        // Return the blocks of the Stream
+        Stream<Collection<T>>
+        blocks() const {
+            return Blocks;
+        };
+
+        // Return the first element of the Stream
+        T
+        head() const;
+
+        // Return a Collection with n elements taken from the Stream, copying
+        // whole blocks at a time
+        Collection<T>
+        take(int n) const;
+
+        // Return a substream of elements of the Stream that match the
+        // predicate function, filtering a block at a time
+        template<typename Function>
+        ChunkedStream<T>
+        filter(Function func) const;
+
+        // Return the Stream that results from the transformation of each
+        // element in the original Stream, mapping a block at a time
+        template<typename Function>
+        ChunkedStream<typename std::result_of<Function(T)>::type>
+        map(Function func) const;
+    };
+
+    // Return the first element of the Stream
+    template<typename T>
+    T
+    ChunkedStream<T>::head() const {
+        Stream<Collection<T>> blocks = Blocks;
+        return blocks.head()[0];
+    }
+
+    // Return a Collection with n elements taken from the Stream
+    template<typename T>
+    Collection<T>
+    ChunkedStream<T>::take(int n) const {
+        Collection<T> result(n);
+        T* list = result.Data;
+        Stream<Collection<T>> blocks = Blocks;
+        for (int taken = 0; taken < n; ) {
+            Collection<T> block = blocks.head();
+            int count = std::min(n - taken, block.Length);
+            std::copy(block.Data, block.Data + count, list + taken);
+            taken += count;
+            if (taken < n)
+                blocks = blocks.tail();
+        }
+        return result;
+    }
+
+    // Return a substream of elements of the Stream that match the predicate
+    // function
+    template<typename T>
+    template<typename Function>
+    ChunkedStream<T>
+    ChunkedStream<T>::filter(Function func) const {
+        return ChunkedStream<T>(Blocks.map([func](Collection<T> block) {
+            return block.filter(func);
+        }));
+    }
+
+    // Return the Stream that results from the transformation of each element
+    // in the original Stream
+    template<typename T>
+    template<typename Function>
+    ChunkedStream<typename std::result_of<Function(T)>::type>
+    ChunkedStream<T>::map(Function func) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+        return ChunkedStream<return_type>(Blocks.map([func](Collection<T> block) {
+            return block.map(func);
+        }));
+    }
+
+    //
+    // Non-member Functions
+    //
+
+    // Throw unless 'block' is a block size the chunked sources can produce
+    inline void
+    check_block(int block) {
+        if (block <= 0)
+            throw std::invalid_argument("block size must be positive, not " +
+                                        std::to_string(block));
+    }
+
+    // Return the blocks of a chunked Stream starting at n, incrementing by step
+    template<typename T>
+    Stream<Collection<T>>
+    from_blocks(T n, T step, int block) {
+        buffer_vector<T> values(block);
+        for (int i = 0; i < block; i++)
+            values[i] = n + T(i) * step;
+        return Stream<Collection<T>>(std::move(values), [=]() -> Stream<Collection<T>> {
+            return from_blocks(T(n + T(block) * step), step, block);
+        });
+    }
+
+    // Construct a chunked Stream, starting at n, incrementing by step
+    template<typename T>
+    ChunkedStream<T>
+    chunked_from(T n, T step=1, int block=stream_block) {
+        check_block(block);
+        return ChunkedStream<T>(from_blocks(n, step, block));
+    }
+
+    // Return the blocks of values returned by repeated calls to a function
+    template<typename Function>
+    Stream<Collection<typename std::result_of<Function()>::type>>
+    generate_blocks(Function func, int block) {
+        using return_type = typename std::result_of<Function()>::type;
+
+        buffer_vector<return_type> values(block);
+        for (int i = 0; i < block; i++)
+            values[i] = func();
+        return Stream<Collection<return_type>>(std::move(values), [=]() -> Stream<Collection<return_type>> {
+            return generate_blocks(func, block);
+        });
+    }
+
+    // Construct a chunked Stream whose values are the return values from
+    // repeated calls the generation function which takes no arguments
+    template<typename Function>
+    ChunkedStream<typename std::result_of<Function()>::type>
+    chunked_generate(Function func, int block=stream_block) {
+        using return_type = typename std::result_of<Function()>::type;
+        check_block(block);
+        return ChunkedStream<return_type>(generate_blocks(func, block));
+    }
+
+    // Return a Stream that repeats the same block
+    template<typename T>
+    Stream<Collection<T>>
+    repeat_blocks(Collection<T> values) {
+        return Stream<Collection<T>>(values, [=]() -> Stream<Collection<T>> {
+            return repeat_blocks(values);
+        });
+    }
+
+    // Construct a chunked Stream that consists of a repeated value, whose
+    // blocks are all the same Collection
+    template<typename T>
+    ChunkedStream<T>
+    chunked_repeat(T value, int block=stream_block) {
+        check_block(block);
+        return ChunkedStream<T>(repeat_blocks(Collection<T>(buffer_vector<T>(block, value))));
+    }
+
+    // Return the blocks of x, f(x), f(f(x)), and so on
+    template<typename T, typename Function>
+    Stream<Collection<T>>
+    iterate_blocks(T value, Function func, int block) {
+        buffer_vector<T> values(block);
+        values[0] = value;
+        for (int i = 1; i < block; i++)
+            values[i] = func(values[i - 1]);
+        T last = values[block - 1];
+        return Stream<Collection<T>>(std::move(values), [=]() -> Stream<Collection<T>> {
+            return iterate_blocks(func(last), func, block);
+        });
+    }
+
+    // Given an initial value x and function f, return the chunked Stream
+    // produced by x, f(x), f(f(x)), and so on
+    template<typename T, typename Function>
+    ChunkedStream<T>
+    chunked_iterate(T value, Function func, int block=stream_block) {
+        check_block(block);
+        return ChunkedStream<T>(iterate_blocks(value, func, block));
+    }
+
+    // A position within the blocks of a chunked Stream
+    template<typename T>
+    class BlockCursor {
+    private:
+        Stream<Collection<T>> Blocks;
+        Collection<T> Block;
+        int Offset;
+
+    public:
+
+        BlockCursor<T>(Stream<Collection<T>> blocks, int offset=0)
+            : Blocks(blocks), Block(blocks.head()), Offset(offset) {};
+
+        // Return the number of elements left in the current block
+        int
+        available() const {
+            return Block.size() - Offset;
+        };
+
+        // Return the next n elements, which are in the current block
+        Collection<T>
+        next(int n) const {
+            return Block.slice(Offset, Offset + n);
+        };
+
+        // Return the cursor n elements further on
+        BlockCursor<T>
+        advance(int n) const {
+            if (Offset + n < Block.size())
+                return BlockCursor<T>(Blocks, Offset + n);
+            return BlockCursor<T>(Blocks.tail());
+        };
+    };
+
+    // Zip the blocks of chunked Streams, cutting them where the shortest
+    // current block ends so blocks that don't line up are still zipped
+    template<typename Function, typename ...U>
+    Stream<Collection<typename std::result_of<Function(U...)>::type>>
+    zip_blocks(Function func, BlockCursor<U>... cursors) {
+        using return_type = typename std::result_of<Function(U...)>::type;
+
+        int n = std::min({cursors.available()...});
+        return Stream<Collection<return_type>>(zip(cursors.next(n)...).map(func),
+            [=]() -> Stream<Collection<return_type>> {
+                return zip_blocks(func, cursors.advance(n)...);
+            });
+    }
+
+    // Generalizes zip by zipping with the function given as the first argument
+    // instead of a tupling function, a block at a time
+    template<typename Function, typename ...U>
+    ChunkedStream<typename std::result_of<Function(U...)>::type>
+    zipWith(Function func, ChunkedStream<U>... other_stream) {
+        using return_type = typename std::result_of<Function(U...)>::type;
+        return ChunkedStream<return_type>(zip_blocks(func, BlockCursor<U>(other_stream.blocks())...));
+    }
+
+    // The tupling function of zip
+    struct make_row {
+        template<typename ...U>
+        std::tuple<U...>
+        operator()(const U&... values) const {
+            return std::tuple<U...>(values...);
+        };
+    };
+
+    // Return a chunked Stream of tuples, where each tuple contains the
+    // elements of the zipped Streams that occur at the same position
+    template<typename ...U>
+    ChunkedStream<std::tuple<U...>>
+    zip(ChunkedStream<U>... other_stream) {
+        return zipWith(make_row(), other_stream...);
+    }
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef COLLECTIONS_H
 #define COLLECTIONS_H
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <functional>
@@ -9,70 +10,322 @@
 #include <list>
 #include <memory>
 #include <stdio.h>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <tuple>
 #include <type_traits>
 #include <vector>
 
-int detectedThreads = (std::thread::hardware_concurrency() == 0) ? \
-    std::thread::hardware_concurrency() : 4;
+#include "buffer.h"
+#include "hash_table.h"
+#include "lazy.h"
+#include "mapped.h"
+#include "simd.h"
+#include "sort.h"
+#include "storage.h"
+#include "thread_pool.h"
+#include "utility.h"
 
 namespace cpp_collections {
 
+    template<typename ...U>
+    class ZippedView;
+
+    template<typename T>
+    class ChunkedCollection;
+
+    template<typename T>
+    class Range;
+
+    template<typename T>
+    class ChunkedStream;
+
+    template<typename Gen>
+    class LazyStream;
+
+    // The element type of a Collection or a Range, for the functions that
+    // accept either of them
+    template<typename C>
+    struct collection_value {};
+
+    template<typename T>
+    struct collection_value<Collection<T>> {
+        using type = T;
+    };
+
+    template<typename T>
+    struct collection_value<Range<T>> {
+        using type = T;
+    };
 
     template<typename T>
     class Collection {
     private:
-        std::vector<T> Data;
+        template<typename ...U>
+        friend class ZippedView;
+
+        template<typename U>
+        friend class ChunkedCollection;
+
+        template<typename U>
+        friend class ChunkedStream;
+
+        template<typename Gen>
+        friend class LazyStream;
+
+        template<typename U>
+        friend class Collection;
+
+        template<typename U>
+        friend class Range;
+
+        template<typename C, typename ...Collections>
+        friend Collection<typename collection_value<C>::type>
+        concat(const C& original, const Collections&... other_list);
+
+        // the elements, which are shared with every view of them, or null
+        // when they are kept Inline
+        std::shared_ptr<T> Buffer;
+        InlineBuffer<T> Inline;
+        // the first element and number of elements of this Collection within
+        // the Buffer or Inline
+        T* Data;
+        int Length;
+
+        // construct a view of 'length' elements starting at 'begin' within a
+        // buffer
+        Collection<T>(std::shared_ptr<T> buffer, T* begin, int length)
+            : Buffer(std::move(buffer)), Data(begin), Length(length) {};
+
+        // Return the elements in [begin, begin + length), which are shared
+        // when they are in a buffer and copied when they are kept inline
+        Collection<T>
+        view(T* begin, int length) const {
+            if (Buffer)
+                return Collection<T>(Buffer, begin, length);
+            Collection<T> result;
+            result.assign(begin, begin + length);
+            return result;
+        };
+
+        // Replace the elements with copies of those in [begin, end), kept
+        // inline when there are few enough of them
+        template<typename Iterator>
+        void
+        assign(Iterator begin, Iterator end) {
+            int length = std::distance(begin, end);
+            if (length > inline_capacity<T>::value) {
+                assign(buffer_vector<T>(begin, end));
+                return;
+            }
+            // types too large to keep inline have no inline storage to copy to
+            if (inline_capacity<T>::value > 0 && length > 0)
+                std::copy(begin, end, Inline.data());
+            Buffer.reset();
+            Data = Inline.data();
+            Length = length;
+        };
+
+        // Replace the elements with those of a std::vector, taking over its
+        // storage unless they fit inline
+        template<typename Allocator>
+        void
+        assign(std::vector<T, Allocator>&& list) {
+            if (int(list.size()) <= inline_capacity<T>::value) {
+                assign(list.begin(), list.end());
+                return;
+            }
+            Length = list.size();
+            Buffer = make_buffer(std::move(list));
+            Data = Buffer.get();
+        };
+
+        // Return the Collection of 'length' elements in a buffer, or an
+        // empty one when there is no buffer
+        static Collection<T>
+        mapped(std::shared_ptr<T> buffer, int length) {
+            if (!buffer)
+                return Collection<T>();
+            T* begin = buffer.get();
+            return Collection<T>(std::move(buffer), begin, length);
+        };
+
+        // Return the elements of the single column of a stored file, which
+        // share its mapping
+        static Collection<T>
+        load(const StoredFile& file, bool verify, std::false_type) {
+            return mapped(file.column<T>(0, verify), file.size());
+        };
+
+        // Return the tuples assembled from the columns of a stored file
+        static Collection<T>
+        load(const StoredFile& file, bool verify, std::true_type) {
+            Collection<T> result(file.size());
+            restore(file, result.Data, result.Length, verify);
+            return result;
+        };
+
+        // Tell the kernel how the elements are about to be read, when they
+        // are in a mapped file
+        void
+        advise(Access access) const {
+            cpp_collections::advise(Buffer, Data, Length, access);
+        };
+
+        // Whether no other Collection or lazy view shares the elements, so
+        // they may be changed in place. Elements in a shared mapping are
+        // never unique, since changing them would change the file.
+        bool
+        unique() const {
+            return !Buffer || (Buffer.use_count() == 1 && !writes_through(Buffer));
+        };
+
+        // Transform the elements of a temporary Collection in place, unless
+        // they are shared
+        template<typename Function>
+        Collection<T>
+        map_in_place(Function func, std::true_type);
+
+        // Transform the elements of a temporary Collection into a new one
+        // when the element type changes
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        map_in_place(Function func, std::false_type);
+
+        // Return the distinct elements that pass a predicate function, in the
+        // order they first appear
+        template<typename Function>
+        Collection<T>
+        distinct_where(Function keep, int threads) const;
+
+        // Return a hash set of the elements, partitioned as partition_by_key does
+        std::vector<HashTable<T, Unit>>
+        hash_set(int threads) const;
+
     public:
 
         // std::vector constructor
         Collection<T>(const std::vector<T>& d) {
-            Data = d;
+            assign(d.begin(), d.end());
+        };
+
+        // std::vector move constructor, which takes over the vector's storage
+        Collection<T>(std::vector<T>&& d) {
+            assign(std::move(d));
+        };
+
+        // std::vector move constructor for elements built in an arena
+        Collection<T>(buffer_vector<T>&& d) {
+            assign(std::move(d));
         };
 
         // construct an empty collection of size 'size'
         Collection<T>(int size) {
-            Data = std::vector<T>(size);
+            if (size > inline_capacity<T>::value) {
+                assign(buffer_vector<T>(size));
+                return;
+            }
+            Data = Inline.data();
+            Length = size;
+            std::fill(Data, Data + size, T());
         };
 
         // construct an empty Collection
         Collection<T>() {
-            Data = std::vector<T>();
+            Data = Inline.data();
+            Length = 0;
         };
 
         // std::list constructor
         Collection<T>(const std::list<T>& d) {
-            Data = std::vector<T>(d.size());
-            int index = 0;
-            for (auto i : d)
-                Data[index++] = i;
+            assign(d.begin(), d.end());
         };
 
         // std::array constructor
         template<std::size_t SIZE>
         Collection<T>(std::array<T, SIZE> d) {
-            Data = std::vector<T>(SIZE);
-            int index = 0;
-            for (auto i : d)
-                Data[index++] = i;
+            assign(d.begin(), d.end());
         };
 
         // C-style array constructor (requires length)
         Collection<T>(T d[], int len) {
-            Data.assign(d, d + len);
+            assign(d, d + len);
+        };
+
+        // Return the elements stored in a binary file of T, mapped into
+        // memory instead of copied. The file is read lazily by the kernel
+        // and never changed: writes to the elements stay private.
+        static Collection<T>
+        mmap(const std::string& path);
+
+        // Return the elements saved to a binary file by save(). Elements of a
+        // trivially copyable type are used in place from a mapping of the
+        // file; tuples are assembled from the file's columns. With 'verify'
+        // every block is first checked against its checksum.
+        static Collection<T>
+        load(const std::string& path, bool verify=false);
+
+        // Save the elements to a binary file, with a header describing them,
+        // the bounds and a checksum of each block of elements, and a
+        // separate column for each element of a tuple
+        void
+        save(const std::string& path) const;
+
+        // Copy constructor, which shares a buffer or copies inline elements
+        Collection<T>(const Collection<T>& other)
+            : Buffer(other.Buffer), Data(other.Data), Length(other.Length) {
+            if (!Buffer)
+                Data = std::copy(other.Data, other.Data + Length, Inline.data()) - Length;
+        };
+
+        // Move constructor, which takes over a buffer or copies inline
+        // elements, leaving the other Collection empty
+        Collection<T>(Collection<T>&& other)
+            : Buffer(std::move(other.Buffer)), Data(other.Data), Length(other.Length) {
+            if (!Buffer)
+                Data = std::copy(other.Data, other.Data + Length, Inline.data()) - Length;
+            other.Data = other.Inline.data();
+            other.Length = 0;
+        };
+
+        // Copy assignment, which shares a buffer or copies inline elements
+        Collection<T>&
+        operator=(const Collection<T>& other) {
+            if (this != &other) {
+                Buffer = other.Buffer;
+                Length = other.Length;
+                Data = Buffer ? other.Data :
+                    std::copy(other.Data, other.Data + Length, Inline.data()) - Length;
+            }
+            return *this;
+        };
+
+        // Move assignment, which takes over a buffer or copies inline
+        // elements, leaving the other Collection empty
+        Collection<T>&
+        operator=(Collection<T>&& other) {
+            if (this != &other) {
+                Buffer = std::move(other.Buffer);
+                Length = other.Length;
+                Data = Buffer ? other.Data :
+                    std::copy(other.Data, other.Data + Length, Inline.data()) - Length;
+                other.Data = other.Inline.data();
+                other.Length = 0;
+            }
+            return *this;
         };
 
         // Overload the [] operator
         T
-        operator[] (const int index) {
+        operator[] (const int index) const {
             return Data[index];
         };
 
         // Overload the == operator
         bool
         operator==(const Collection<T>& other) {
-            return Data == other.Data;
+            return Length == other.Length && std::equal(Data, Data + Length, other.Data);
         };
 
         // Overload the << operator
@@ -80,9 +333,9 @@ namespace cpp_collections {
         operator<<(std::ostream& stream, const Collection<T>& f) {
             stream << "[";
 
-            for (int i = 0; i < f.Data.size() - 1; i++)
+            for (int i = 0; i < f.Length - 1; i++)
                 stream << f.Data[i] << ",";
-            stream << f.Data[f.Data.size() - 1];
+            stream << f.Data[f.Length - 1];
 
             stream << "]";
             return stream;
@@ -91,18 +344,42 @@ namespace cpp_collections {
         // Return Collection as a std::vector
         std::vector<T>
         vector() {
-            return Data;
+            return std::vector<T>(Data, Data + Length);
         };
 
         // Return Collection as a std::list
         std::list<T>
         list() {
-            return std::list<T>(std::begin(Data), std::end(Data));
+            return std::list<T>(Data, Data + Length);
+        };
+
+        // Return an iterator to the first element, so a Collection can be
+        // used in range-based for loops and handed to STL algorithms without
+        // copying its elements
+        const T*
+        begin() const {
+            return Data;
+        };
+
+        // Return an iterator past the last element
+        const T*
+        end() const {
+            return Data + Length;
         };
 
+        // Return a lazy view of the Collection, whose map, filter, slice and
+        // zipWith calls are fused into a single pass by a terminal operation
+        LazyCollection<LazySource<T>>
+        lazy() const &;
+
+        // Return a lazy view that takes ownership of a temporary Collection's
+        // elements
+        LazyCollection<LazySource<T>>
+        lazy() &&;
+
         // Return the size of the Collection
         int
-        size();
+        size() const;
 
         // Return the first element
         T
@@ -112,53 +389,133 @@ namespace cpp_collections {
         T
         last();
 
-        // Return all the elements except the last
+        // Return all the elements except the last, as a view that shares
+        // them with the Collection
         Collection<T>
-        init();
+        init() const;
 
-        // Return all the elements except the head
+        // Return all the elements except the head, as a view that shares them
+        // with the Collection
+        Collection<T>
+        tail() const;
+
+        // Return a Collection that owns a copy of just its own elements, so
+        // that a small view stops keeping a large buffer alive
         Collection<T>
-        tail();
+        materialize() const;
 
         // Apply a function to all the elements in the Collection
+        template<typename Function>
         void
-        each(std::function<void(T)> func);
+        each(Function func);
 
         // Return the elements that pass a predicate function
+        template<typename Function>
         Collection<T>
-        filter(std::function<bool(T)> func);
+        filter(Function func) const &;
 
-        // Return the elements whose indices are within the range [low, high)
+        // Return the elements that pass a predicate function, compacting a
+        // temporary Collection in place unless its elements are shared
+        template<typename Function>
+        Collection<T>
+        filter(Function func) &&;
+
+        // An alternative implementation of filter that tests the elements on
+        // the shared worker pool and writes the survivors into a single
+        // allocation of the exact size, preserving their order
+        template<typename Function>
         Collection<T>
-        slice(int low, int high);
+        tfilter(Function func, int threads=detectedThreads) const;
+
+        // Return the elements whose indices are within the range [low, high),
+        // as a view that shares them with the Collection
+        Collection<T>
+        slice(int low, int high) const;
 
         // Return the Collection that results from the transformation of each
         // element in the original Collection
         template<typename Function>
         Collection<typename std::result_of<Function(T)>::type>
-        map(Function func) const;
+        map(Function func) const &;
+
+        // Return the Collection that results from the transformation of each
+        // element in the original Collection, transforming a temporary
+        // Collection in place when the element type doesn't change and its
+        // elements aren't shared
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        map(Function func) &&;
 
-        // An alternative implementation of map that uses multiple concurrent
-        // std::threads to speed up processing
+        // An alternative implementation of map that splits the Collection into
+        // 'threads' chunks and processes them on the shared worker pool
         template<typename Function>
         Collection<typename std::result_of<Function(T)>::type>
         tmap(Function func, int threads=detectedThreads) const;
 
+        // Return the transformed elements in a binary file created at 'path',
+        // writing them through a shared memory mapping of the file
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        map(Function func, const std::string& path) const;
+
+        // Return the transformed elements in a binary file created at 'path',
+        // writing them from the shared worker pool
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        tmap(Function func, const std::string& path, int threads=detectedThreads) const;
+
         // Return the result of the application of the same binary operator on
         // adjacent pairs of elements in the Collection, starting from the left
+        template<typename Function>
         T
-        reduceLeft(std::function<T(T, T)> func);
+        reduceLeft(Function func);
 
         // Return the result of the application of the same binary operator on
         // adjacent pairs of elements in the Collection, starting from the right
+        template<typename Function>
+        T
+        reduceRight(Function func);
+
+        // An alternative implementation of reduce that splits the Collection
+        // into 'threads' chunks and reduces them on the shared worker pool
+        // (note that the function passed to treduce must be commutative to
+        // achieve accurate result)
+        template<typename Function>
+        T
+        treduce(Function func, int threads=detectedThreads);
+
+        // Fold each chunk of the Collection into init with seqOp on the shared
+        // worker pool, then merge the chunk results with combOp (note that
+        // init is used once per chunk, so it must be neutral for combOp, and
+        // combOp must be commutative to achieve accurate result)
+        template<typename U, typename SeqOp, typename CombOp>
+        U
+        aggregate(U init, SeqOp seqOp, CombOp combOp, int threads=detectedThreads) const;
+
+        // Return the sum of the elements, using vector instructions for int,
+        // int64_t, float and double Collections (note that floating point
+        // sums are added in a different order than reduceLeft would use)
+        T
+        sum(int threads=1) const;
+
+        // Return the smallest element, using vector instructions for int,
+        // int64_t, float and double Collections
         T
-        reduceRight(std::function<T(T, T)> func);
+        min(int threads=1) const;
 
-        // An alternative implementation of reduce that uses multiple concurrent
-        // std::threads to speed up processing (note that the function passed to
-        // treduce must be commutative to achieve accurate result)
+        // Return the largest element, using vector instructions for int,
+        // int64_t, float and double Collections
         T
-        treduce(std::function<T(T, T)> func, int threads=detectedThreads);
+        max(int threads=1) const;
+
+        // Return the smallest and the largest element in a single pass
+        std::pair<T, T>
+        minmax(int threads=1) const;
+
+        // Return the number of elements that pass a predicate function
+        template<typename Function>
+        int
+        count(Function func, int threads=1) const;
 
         // Return the result of the application of the same binary operator on
         // all elements in the Collection as well as an initial value, starting
@@ -188,6 +545,93 @@ namespace cpp_collections {
         Collection<typename std::result_of<Function(U, T)>::type>
         scanRight(Function func, U init);
 
+
+        // An alternative implementation of scanLeft that runs a two-pass
+        // block scan on the shared worker pool (note that the function passed
+        // to tscanLeft must be associative, and must also accept two
+        // accumulated values, to achieve accurate result)
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        tscanLeft(Function func, U init, int threads=detectedThreads);
+
+        // An alternative implementation of scanRight that runs a two-pass
+        // block scan on the shared worker pool (note that the function passed
+        // to tscanRight must be associative, and must also accept two
+        // accumulated values, to achieve accurate result)
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        tscanRight(Function func, U init, int threads=detectedThreads);
+
+        // Return the elements in ascending order, radix sorting integer and
+        // floating point elements and merge sorting the rest, in chunks on
+        // the shared worker pool
+        Collection<T>
+        sort(int threads=detectedThreads) const &;
+
+        // Return the elements in ascending order, sorting a temporary
+        // Collection in place unless its elements are shared
+        Collection<T>
+        sort(int threads=detectedThreads) &&;
+
+        // Return the elements in ascending order of the keys a function
+        // returns for them, radix sorting integer and floating point keys and
+        // merge sorting the rest (note that equal keys may be reordered)
+        template<typename Function>
+        Collection<T>
+        sortBy(Function key, int threads=detectedThreads) const;
+
+        // Return the elements in ascending order of the keys a function
+        // returns for them, keeping the order of elements with equal keys
+        template<typename Function>
+        Collection<T>
+        stableSortBy(Function key, int threads=detectedThreads) const;
+
+        // Return every key that a function returns for the elements, paired
+        // with the elements that have that key in their original order.
+        // With more than one thread the keys are partitioned by hash on the
+        // shared worker pool, and come out grouped by partition instead of
+        // in the order they first appear.
+        template<typename Function>
+        Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, Collection<T>>>
+        groupBy(Function key, int threads=1) const;
+
+        // Return every key that a function returns for the elements, paired
+        // with the number of elements that have it
+        template<typename Function>
+        Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, int>>
+        countBy(Function key, int threads=1) const;
+
+        // Return every key that a function returns for the elements, paired
+        // with the result of combining the values that another function
+        // returns for the elements with that key (note that combine must be
+        // associative, and commutative with more than one thread, to achieve
+        // accurate result)
+        template<typename KeyFunction, typename ValueFunction, typename Combine>
+        Collection<std::pair<typename std::decay<typename std::result_of<KeyFunction(T)>::type>::type,
+                             typename std::decay<typename std::result_of<ValueFunction(T)>::type>::type>>
+        reduceByKey(KeyFunction key, ValueFunction value, Combine combine, int threads=1) const;
+
+        // Return the elements without repeats, in the order they first appear.
+        // With more than one thread the elements are partitioned by hash on
+        // the shared worker pool, and the positions of their first appearances
+        // are radix sorted to restore their order.
+        Collection<T>
+        distinct(int threads=1) const;
+
+        // Return the distinct elements that are also in another Collection, in
+        // the order they first appear
+        Collection<T>
+        intersect(const Collection<T>& other, int threads=1) const;
+
+        // Return the distinct elements of either Collection, those of this
+        // Collection first
+        Collection<T>
+        union_(const Collection<T>& other, int threads=1) const;
+
+        // Return the distinct elements that aren't in another Collection, in
+        // the order they first appear
+        Collection<T>
+        diff(const Collection<T>& other, int threads=1) const;
     };
 
     // --------------------------
@@ -197,8 +641,8 @@ namespace cpp_collections {
     // Return the size of the Collection
     template<typename T>
     int
-    Collection<T>::size() {
-        return Data.size();
+    Collection<T>::size() const {
+        return Length;
     }
 
     // Return the first element
@@ -214,23 +658,87 @@ namespace cpp_collections {
     T
     Collection<T>::last() {
         // TODO: add emptiness checking
-        return Data[Data.size() - 1];
+        return Data[Length - 1];
     }
 
-    // Return all the elements except the last
+    // Return all the elements except the last, as a view that shares them
+    // with the Collection
     template<typename T>
     Collection<T>
-    Collection<T>::init() {
+    Collection<T>::init() const {
         // TODO: add emptiness checking
-        return Collection<T>(std::vector<T>(Data.begin(), Data.end() - 1));
+        return view(Data, Length - 1);
     }
 
-    // Return all the elements except the head
+    // Return all the elements except the head, as a view that shares them
+    // with the Collection
     template<typename T>
     Collection<T>
-    Collection<T>::tail() {
+    Collection<T>::tail() const {
         // TODO: add emptiness checking
-        return Collection<T>(std::vector<T>(Data.begin() + 1, Data.end()));
+        return view(Data + 1, Length - 1);
+    }
+
+    // Return a Collection that owns a copy of just its own elements, so that
+    // a small view stops keeping a large buffer alive
+    template<typename T>
+    Collection<T>
+    Collection<T>::materialize() const {
+        // a std::vector rather than a buffer_vector, to escape any arena
+        if (Length > inline_capacity<T>::value)
+            return Collection<T>(std::vector<T>(Data, Data + Length));
+        Collection<T> result;
+        result.assign(Data, Data + Length);
+        return result;
+    }
+
+    // Return a lazy view of the Collection, whose map, filter, slice and
+    // zipWith calls are fused into a single pass by a terminal operation
+    template<typename T>
+    LazyCollection<LazySource<T>>
+    Collection<T>::lazy() const & {
+        return LazySource<T>{Data, Length, nullptr};
+    }
+
+    // Return a lazy view that takes ownership of a temporary Collection's
+    // elements
+    template<typename T>
+    LazyCollection<LazySource<T>>
+    Collection<T>::lazy() && {
+        // inline elements die with the Collection, so move them to a buffer
+        if (!Buffer) {
+            auto owner = make_buffer(std::vector<T>(Data, Data + Length));
+            return LazySource<T>{owner.get(), Length, owner};
+        }
+        LazySource<T> source{Data, Length, std::move(Buffer)};
+        Data = Inline.data();
+        Length = 0;
+        return source;
+    }
+
+    // Return the elements stored in a binary file of T, mapped into memory
+    // instead of copied
+    template<typename T>
+    Collection<T>
+    Collection<T>::mmap(const std::string& path) {
+        int length;
+        auto buffer = map_file<T>(path, length);
+        return mapped(std::move(buffer), length);
+    }
+
+    // Return the elements saved to a binary file by save()
+    template<typename T>
+    Collection<T>
+    Collection<T>::load(const std::string& path, bool verify) {
+        StoredFile file(path);
+        return load(file, verify, is_tuple<T>());
+    }
+
+    // Save the elements to a binary file
+    template<typename T>
+    void
+    Collection<T>::save(const std::string& path) const {
+        store(path, static_cast<const T*>(Data), Length);
     }
 
     // --------------------------
@@ -239,31 +747,104 @@ namespace cpp_collections {
 
     // Apply a function to all the elements in the Collection
     template<typename T>
+    template<typename Function>
     void
-    Collection<T>::each(std::function<void(T)> func) {
-        for (auto i : Data)
-            func(i);
+    Collection<T>::each(Function func) {
+        advise(Access::Sequential);
+        for (int i = 0; i < Length; i++)
+            func(static_cast<const T&>(Data[i]));
     }
 
     // Return the elements that pass a predicate function
     template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::filter(Function func) const & {
+        advise(Access::Sequential);
+        // the survivors of a small Collection fit inline as well
+        if (Length <= inline_capacity<T>::value) {
+            Collection<T> result;
+            for (int i = 0; i < Length; i++)
+                if (func(static_cast<const T&>(Data[i])))
+                    result.Data[result.Length++] = Data[i];
+            return result;
+        }
+
+        buffer_vector<T> list;
+        for (int i = 0; i < Length; i++)
+            if (func(static_cast<const T&>(Data[i])))
+                list.push_back(Data[i]);
+        return Collection<T>(std::move(list));
+    }
+
+    // Return the elements that pass a predicate function, compacting a
+    // temporary Collection in place unless its elements are shared
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::filter(Function func) && {
+        advise(Access::Sequential);
+        if (!unique())
+            return filter(func);
+
+        int kept = 0;
+        for (int i = 0; i < Length; i++) {
+            if (func(static_cast<const T&>(Data[i]))) {
+                if (kept != i)
+                    Data[kept] = std::move(Data[i]);
+                kept++;
+            }
+        }
+        Length = kept;
+        return std::move(*this);
+    }
+
+    // An alternative implementation of filter that tests the elements on the
+    // shared worker pool and writes the survivors into a single allocation of
+    // the exact size, preserving their order
+    template<typename T>
+    template<typename Function>
     Collection<T>
-    Collection<T>::filter(std::function<bool(T)> func) {
-        std::vector<T> list;
-        for (auto i : Data)
-            if (func(i))
-                list.push_back(i);
-        return Collection<T>(list);
+    Collection<T>::tfilter(Function func, int threads) const {
+        advise(Access::Parallel);
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<char> keep(Length);
+        std::vector<int> offsets(chunks + 1, 0);
+
+        // test every element, counting the survivors of each chunk
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                int count = 0;
+                for (int i = begin; i < end; i++) {
+                    keep[i] = func(Data[i]) ? 1 : 0;
+                    count += keep[i];
+                }
+                offsets[chunk + 1] = count;
+            });
+
+        // each chunk writes its survivors after those of earlier chunks
+        for (int i = 0; i < chunks; i++)
+            offsets[i + 1] += offsets[i];
+
+        Collection<T> result(offsets[chunks]);
+        T* list = result.Data;
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                int index = offsets[chunk];
+                for (int i = begin; i < end; i++)
+                    if (keep[i])
+                        list[index++] = Data[i];
+            });
+        return result;
     }
 
-    // Return the elements whose indices are within the range [low, high)
+    // Return the elements whose indices are within the range [low, high), as
+    // a view that shares them with the Collection
     template<typename T>
     Collection<T>
-    Collection<T>::slice(int low, int high) {
-        std::vector<T> list(high-low);
-        for (int i = 0; i < high-low; i++)
-            list[i] = Data[i+low];
-        return Collection<T>(list);
+    Collection<T>::slice(int low, int high) const {
+        // TODO: bounds checking
+        return view(Data + low, high - low);
     }
 
     // Return the Collection that results from the transformation of each
@@ -271,65 +852,121 @@ namespace cpp_collections {
     template<typename T>
     template<typename Function>
     Collection<typename std::result_of<Function(T)>::type>
-    Collection<T>::map(Function func) const {
+    Collection<T>::map(Function func) const & {
         using return_type = typename std::result_of<Function(T)>::type;
 
-        std::vector<return_type> list(Data.size());
-        for (int i = 0; i < Data.size(); i++)
+        advise(Access::Sequential);
+        Collection<return_type> result(Length);
+        return_type* list = result.Data;
+        for (int i = 0; i < Length; i++)
             list[i] = func(Data[i]);
-        return Collection<return_type>(list);
+        return result;
     }
 
-    template<typename T, typename Function>
-    void
-    tmap_thread(int begin, int end, Function func, std::vector<T>& list) {
-        for (int i = begin; i < end && i < list.size(); i++)
-            list[i] = func(list[i]);
+    // Transform the elements of a temporary Collection in place, unless they
+    // are shared
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::map_in_place(Function func, std::true_type) {
+        if (!unique())
+            return map(func);
+
+        for (int i = 0; i < Length; i++)
+            Data[i] = func(static_cast<const T&>(Data[i]));
+        return std::move(*this);
     }
 
-    // An alternative implementation of map that uses multiple concurrent
-    // std::threads to speed up processing
+    // Transform the elements of a temporary Collection into a new one when
+    // the element type changes
     template<typename T>
     template<typename Function>
     Collection<typename std::result_of<Function(T)>::type>
-    Collection<T>::tmap(Function func, int threads) const {
-        std::vector<std::thread> thread_pool(threads);
-
-        // TODO: add bounds checking
-        int chunk = Data.size() / threads;
-        int extra = Data.size() - chunk*threads;
-        std::vector<int> indices(extra, chunk+1);
-        std::vector<int> normal(threads-extra, chunk);
-        indices.insert(indices.end(), normal.begin(), normal.end());
+    Collection<T>::map_in_place(Function func, std::false_type) {
+        return map(func);
+    }
 
-        std::vector<T> NewData = Data;
+    // Return the Collection that results from the transformation of each
+    // element in the original Collection, transforming a temporary Collection
+    // in place when the element type doesn't change and its elements aren't
+    // shared
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Collection<T>::map(Function func) && {
+        using return_type = typename std::result_of<Function(T)>::type;
+        return map_in_place(func, std::is_same<return_type, T>());
+    }
 
-        int start = 0;
-        for (int i = 0; i < threads; i++) {
-            int end = start + indices[i];
+    // An alternative implementation of map that splits the Collection into
+    // chunks for 'threads' workers and processes them on the shared
+    // work-stealing pool
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Collection<T>::tmap(Function func, int threads) const {
+        using return_type = typename std::result_of<Function(T)>::type;
 
-            thread_pool[i] = std::thread ([=, &NewData]() {
-                tmap_thread(start, end, func, NewData);
+        advise(Access::Parallel);
+        Collection<return_type> result(Length);
+        return_type* list = result.Data;
+        thread_pool().parallel_for(0, Length,
+            parallel_chunks(Length, threads), threads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    list[i] = func(Data[i]);
             });
+        return result;
+    }
 
-            start = end;
-        }
+    // Return the transformed elements in a binary file created at 'path',
+    // writing them through a shared memory mapping of the file
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Collection<T>::map(Function func, const std::string& path) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        advise(Access::Sequential);
+        auto result = Collection<return_type>::mapped(
+            create_file<return_type>(path, Length), Length);
+        return_type* list = result.Data;
+        for (int i = 0; i < Length; i++)
+            list[i] = func(Data[i]);
+        return result;
+    }
 
-        for (int i = 0; i < threads; i++)
-            thread_pool[i].join();
+    // Return the transformed elements in a binary file created at 'path',
+    // writing them from the shared worker pool
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Collection<T>::tmap(Function func, const std::string& path, int threads) const {
+        using return_type = typename std::result_of<Function(T)>::type;
 
-        std::cout << NewData[0] << std::endl;
-        return Collection<T>(NewData);
+        advise(Access::Parallel);
+        auto result = Collection<return_type>::mapped(
+            create_file<return_type>(path, Length), Length);
+        return_type* list = result.Data;
+        thread_pool().parallel_for(0, Length,
+            parallel_chunks(Length, threads), threads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    list[i] = func(Data[i]);
+            });
+        return result;
     }
 
     // Return the result of the application of the same binary operator on
     // adjacent pairs of elements in the Collection, starting from the left
     template<typename T>
+    template<typename Function>
     T
-    Collection<T>::reduceLeft(std::function<T(T, T)> func) {
+    Collection<T>::reduceLeft(Function func) {
+        advise(Access::Sequential);
         // TODO: bounds checking
         T val = func(Data[0], Data[1]);
-        for (int i = 2; i < Data.size(); i++)
+        for (int i = 2; i < Length; i++)
             val = func(val, Data[i]);
 
         return val;
@@ -338,85 +975,219 @@ namespace cpp_collections {
     // Return the result of the application of the same binary operator on
     // adjacent pairs of elements in the Collection, starting from the right
     template<typename T>
+    template<typename Function>
     T
-    Collection<T>::reduceRight(std::function<T(T, T)> func) {
+    Collection<T>::reduceRight(Function func) {
         // TODO: bounds checking
-        T val = func(Data[Data.size() - 1], Data[Data.size() - 2]);
-        for (int i = Data.size() - 3; i >= 0; i--)
+        T val = func(Data[Length - 1], Data[Length - 2]);
+        for (int i = Length - 3; i >= 0; i--)
             val = func(val, Data[i]);
 
         return val;
     }
 
+    // An alternative implementation of reduce that splits the Collection into
+    // chunks for 'threads' workers and reduces them on the shared
+    // work-stealing pool (note that the function passed to treduce must be
+    // commutative to achieve accurate result)
     template<typename T>
-    void
-    treduce_thread(int tid, int begin, int end, std::function<T(T, T)> func,
-                   std::vector<T>& list, std::vector<T>& results) {
-        T val = func(list[begin], list[begin + 1]);
-        for (int i = begin + 2; i < end && i < list.size(); i++)
-            val = func(val, list[i]);
-        results[tid] = val;
+    template<typename Function>
+    T
+    Collection<T>::treduce(Function func, int threads) {
+        advise(Access::Parallel);
+        // TODO: bounds checking
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<T> results(chunks);
+
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                T val = Data[begin];
+                for (int i = begin + 1; i < end; i++)
+                    val = func(val, Data[i]);
+                results[chunk] = val;
+            });
+
+        T val = results[0];
+        for (int i = 1; i < chunks; i++)
+            val = func(val, results[i]);
+        return val;
     }
 
-    // An alternative implementation of reduce that uses multiple concurrent
-    // threads to speed up processing (note that the function passed to
-    // treduce must be commutative to achieve accurate result)
+    // Return the sum of the elements, using vector instructions for int,
+    // int64_t, float and double Collections. With more than one thread each
+    // chunk is summed with the vector kernel on the shared worker pool.
     template<typename T>
     T
-    Collection<T>::treduce(std::function<T(T, T)> func, int threads) {
-        std::vector<std::thread> thread_pool(threads);
-        std::vector<T> results(threads);
-
-        // TODO: add bounds checking
-        int chunk = Data.size() / threads;
-        int extra = Data.size() - chunk*threads;
-        std::vector<int> indices(extra, chunk+1);
-        std::vector<int> normal(threads-extra, chunk);
-        indices.insert(indices.end(), normal.begin(), normal.end());
-
-        int start = 0;
-        for (int i = 0; i < threads; i++) {
-            int end = start + indices[i];
-
-            thread_pool[i] = std::thread ([=, &results]() {
-                treduce_thread(i, start, end, func, Data, results);
+    Collection<T>::sum(int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        if (threads <= 1)
+            return simd_kernels<T>::sum(Data, Length);
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<T> results(chunks, T());
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                results[chunk] = simd_kernels<T>::sum(Data + begin, end - begin);
             });
+        return simd_kernels<T>::sum(results.data(), chunks);
+    }
 
-            start = end;
-        }
+    // Return the smallest element, using vector instructions for int,
+    // int64_t, float and double Collections
+    template<typename T>
+    T
+    Collection<T>::min(int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        if (Length == 0)
+            throw std::length_error("min of an empty Collection");
+        if (threads <= 1)
+            return simd_kernels<T>::min(Data, Length);
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<T> results(chunks, Data[0]);
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                results[chunk] = simd_kernels<T>::min(Data + begin, end - begin);
+            });
+        return simd_kernels<T>::min(results.data(), chunks);
+    }
 
-        for (int i = 0; i < thread_pool.size(); i++)
-            thread_pool[i].join();
+    // Return the largest element, using vector instructions for int,
+    // int64_t, float and double Collections
+    template<typename T>
+    T
+    Collection<T>::max(int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        if (Length == 0)
+            throw std::length_error("max of an empty Collection");
+        if (threads <= 1)
+            return simd_kernels<T>::max(Data, Length);
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<T> results(chunks, Data[0]);
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                results[chunk] = simd_kernels<T>::max(Data + begin, end - begin);
+            });
+        return simd_kernels<T>::max(results.data(), chunks);
+    }
 
-        // TODO: check that results has size greater than 1
-        T val = func(results[0], results[1]);
-        for (int i = 2; i < results.size(); i++)
-            val = func(val, results[i]);
+    // Run the min and max kernels over cache-sized blocks, so that the max
+    // pass reads each block from cache rather than memory
+    template<typename T>
+    std::pair<T, T>
+    minmax_blocks(const T* data, int n) {
+        const int block = 4096;
+        std::pair<T, T> val(data[0], data[0]);
+        for (int i = 0; i < n; i += block) {
+            int len = std::min(block, n - i);
+            val.first = MinOp::apply(val.first, simd_kernels<T>::min(data + i, len));
+            val.second = MaxOp::apply(val.second, simd_kernels<T>::max(data + i, len));
+        }
         return val;
     }
 
-    // Return the result of the application of the same binary operator on
-    // all elements in the Collection as well as an initial value, starting
-    // from the left
+    // Return the smallest and the largest element in a single pass
     template<typename T>
-    template<typename Function, typename U>
-    typename std::result_of<Function(U, T)>::type
-    Collection<T>::foldLeft(Function func, U init) {
-        using return_type = typename std::result_of<Function(U, T)>::type;
-        static_assert(std::is_same<return_type, U>::value,
-            "Fold fn must return the same type as the initial value");
-
-        // TODO: bounds checking
-        return_type val = func(init, Data[0]);
-        for (int i = 1; i < Data.size(); i++)
-            val = func(val, Data[i]);
+    std::pair<T, T>
+    Collection<T>::minmax(int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        if (Length == 0)
+            throw std::length_error("minmax of an empty Collection");
+        if (threads <= 1)
+            return minmax_blocks(Data, Length);
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<std::pair<T, T>> results(chunks, std::make_pair(Data[0], Data[0]));
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                results[chunk] = minmax_blocks(Data + begin, end - begin);
+            });
 
+        std::pair<T, T> val = results[0];
+        for (int i = 1; i < chunks; i++) {
+            val.first = MinOp::apply(val.first, results[i].first);
+            val.second = MaxOp::apply(val.second, results[i].second);
+        }
         return val;
     }
 
-    // Return the result of the application of the same binary operator on
-    // all elements in the Collection as well as an initial value, starting
-    // from the right
+    // Return the number of elements that pass a predicate function
+    template<typename T>
+    template<typename Function>
+    int
+    Collection<T>::count(Function func, int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        if (threads <= 1) {
+            int val = 0;
+            for (int i = 0; i < Length; i++)
+                val += func(Data[i]) ? 1 : 0;
+            return val;
+        }
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<int> results(chunks, 0);
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                int val = 0;
+                for (int i = begin; i < end; i++)
+                    val += func(Data[i]) ? 1 : 0;
+                results[chunk] = val;
+            });
+
+        int val = 0;
+        for (int i = 0; i < chunks; i++)
+            val += results[i];
+        return val;
+    }
+
+    // Fold each chunk of the Collection into init with seqOp on the shared
+    // worker pool, then merge the chunk results with combOp
+    template<typename T>
+    template<typename U, typename SeqOp, typename CombOp>
+    U
+    Collection<T>::aggregate(U init, SeqOp seqOp, CombOp combOp, int threads) const {
+        advise(Access::Parallel);
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<U> results(chunks, init);
+
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                U val = init;
+                for (int i = begin; i < end; i++)
+                    val = seqOp(val, Data[i]);
+                results[chunk] = val;
+            });
+
+        U val = results[0];
+        for (int i = 1; i < chunks; i++)
+            val = combOp(val, results[i]);
+        return val;
+    }
+
+    // Return the result of the application of the same binary operator on
+    // all elements in the Collection as well as an initial value, starting
+    // from the left
+    template<typename T>
+    template<typename Function, typename U>
+    typename std::result_of<Function(U, T)>::type
+    Collection<T>::foldLeft(Function func, U init) {
+        using return_type = typename std::result_of<Function(U, T)>::type;
+        static_assert(std::is_same<return_type, U>::value,
+            "Fold fn must return the same type as the initial value");
+
+        // TODO: bounds checking
+        advise(Access::Sequential);
+        return_type val = func(init, Data[0]);
+        for (int i = 1; i < Length; i++)
+            val = func(val, Data[i]);
+
+        return val;
+    }
+
+    // Return the result of the application of the same binary operator on
+    // all elements in the Collection as well as an initial value, starting
+    // from the right
     template<typename T>
     template<typename Function, typename U>
     typename std::result_of<Function(U, T)>::type
@@ -426,8 +1197,8 @@ namespace cpp_collections {
             "Fold fn must return the same type as the initial value");
 
         // TODO: bounds checking
-        return_type val = func(init, Data[Data.size() - 1]);
-        for (int i = Data.size() - 2; i >= 0; i--)
+        return_type val = func(init, Data[Length - 1]);
+        for (int i = Length - 2; i >= 0; i--)
             val = func(val, Data[i]);
 
         return val;
@@ -444,11 +1215,12 @@ namespace cpp_collections {
         static_assert(std::is_same<return_type, U>::value,
             "Scan fn must return the same type as the initial value");
 
-        std::vector<return_type> list(Data.size() + 1);
+        Collection<return_type> result(Length + 1);
+        return_type* list = result.Data;
         list[0] = init;
-        for (int i = 0; i < Data.size(); i++)
+        for (int i = 0; i < Length; i++)
             list[i + 1] = func(list[i], Data[i]);
-        return Collection<return_type>(list);
+        return result;
     }
 
     // Returns the intermediate results of the binary accumulation of the
@@ -462,11 +1234,1026 @@ namespace cpp_collections {
         static_assert(std::is_same<return_type, U>::value,
             "Scan fn must return the same type as the initial value");
 
-        std::vector<return_type> list(Data.size() + 1);
-        list[list.size() - 1] = init;
-        for (int i = list.size() - 2; i >= 0; i--)
+        Collection<return_type> result(Length + 1);
+        return_type* list = result.Data;
+        list[Length] = init;
+        for (int i = Length - 1; i >= 0; i--)
             list[i] = func(list[i + 1], Data[i]);
-        return Collection<return_type>(list);
+        return result;
+    }
+
+    // An alternative implementation of scanLeft that runs a two-pass block
+    // scan on the shared worker pool, or a single pass with one thread
+    template<typename T>
+    template<typename Function, typename U>
+    Collection<typename std::result_of<Function(U, T)>::type>
+    Collection<T>::tscanLeft(Function func, U init, int threads) {
+        using return_type = typename std::result_of<Function(U, T)>::type;
+        static_assert(std::is_same<return_type, U>::value,
+            "Scan fn must return the same type as the initial value");
+        if (threads <= 1)
+            return scanLeft(func, init);
+
+        // clamp the chunks to the elements as parallel_for does, so that an
+        // empty Collection has no block totals to scan
+        int chunks = std::min(parallel_chunks(Length, threads), Length);
+        Collection<return_type> result(Length + 1);
+        return_type* list = result.Data;
+        std::vector<return_type> totals(chunks + 1);
+
+        // reduce each block on its own
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                return_type val = Data[begin];
+                for (int i = begin + 1; i < end; i++)
+                    val = func(val, Data[i]);
+                totals[chunk + 1] = val;
+            });
+
+        // scan the block totals, so each block knows the value it starts from
+        totals[0] = init;
+        for (int i = 1; i <= chunks; i++)
+            totals[i] = func(totals[i - 1], totals[i]);
+
+        // rescan each block from its starting value
+        list[0] = init;
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                return_type val = totals[chunk];
+                for (int i = begin; i < end; i++)
+                    list[i + 1] = val = func(val, Data[i]);
+            });
+        return result;
+    }
+
+    // An alternative implementation of scanRight that runs a two-pass block
+    // scan on the shared worker pool, or a single pass with one thread
+    template<typename T>
+    template<typename Function, typename U>
+    Collection<typename std::result_of<Function(U, T)>::type>
+    Collection<T>::tscanRight(Function func, U init, int threads) {
+        using return_type = typename std::result_of<Function(U, T)>::type;
+        static_assert(std::is_same<return_type, U>::value,
+            "Scan fn must return the same type as the initial value");
+        if (threads <= 1)
+            return scanRight(func, init);
+
+        // clamp the chunks to the elements as parallel_for does, so that an
+        // empty Collection has no block totals to scan
+        int chunks = std::min(parallel_chunks(Length, threads), Length);
+        Collection<return_type> result(Length + 1);
+        return_type* list = result.Data;
+        std::vector<return_type> totals(chunks + 1);
+
+        // reduce each block on its own, from the right
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                return_type val = Data[end - 1];
+                for (int i = end - 2; i >= begin; i--)
+                    val = func(val, Data[i]);
+                totals[chunk] = val;
+            });
+
+        // scan the block totals from the right, so each block knows the
+        // value it starts from
+        totals[chunks] = init;
+        for (int i = chunks - 1; i >= 0; i--)
+            totals[i] = func(totals[i + 1], totals[i]);
+
+        // rescan each block from its starting value
+        list[Length] = init;
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                return_type val = totals[chunk + 1];
+                for (int i = end - 1; i >= begin; i--)
+                    list[i] = val = func(val, Data[i]);
+            });
+        return result;
+    }
+
+    // --------------------------
+    // SORTING
+    // --------------------------
+
+    // Return the elements in ascending order
+    template<typename T>
+    Collection<T>
+    Collection<T>::sort(int threads) const & {
+        advise(Access::Sequential);
+        Collection<T> result(Length);
+        std::copy(Data, Data + Length, result.Data);
+        sort_elements(result.Data, Length, threads, radix_key<T>());
+        return result;
+    }
+
+    // Return the elements in ascending order, sorting a temporary Collection
+    // in place unless its elements are shared
+    template<typename T>
+    Collection<T>
+    Collection<T>::sort(int threads) && {
+        if (!unique())
+            return sort(threads);
+
+        sort_elements(Data, Length, threads, radix_key<T>());
+        return std::move(*this);
+    }
+
+    // Return the elements in ascending order of the keys a function returns
+    // for them
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::sortBy(Function key, int threads) const {
+        using key_type = typename std::decay<typename std::result_of<Function(T)>::type>::type;
+
+        advise(Access::Sequential);
+        Collection<T> result(Length);
+        std::copy(Data, Data + Length, result.Data);
+        sort_by_key(result.Data, Length, key, false, threads, radix_key<key_type>());
+        return result;
+    }
+
+    // Return the elements in ascending order of the keys a function returns
+    // for them, keeping the order of elements with equal keys
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::stableSortBy(Function key, int threads) const {
+        using key_type = typename std::decay<typename std::result_of<Function(T)>::type>::type;
+
+        advise(Access::Sequential);
+        Collection<T> result(Length);
+        std::copy(Data, Data + Length, result.Data);
+        sort_by_key(result.Data, Length, key, true, threads, radix_key<key_type>());
+        return result;
+    }
+
+    // --------------------------
+    // GROUPING
+    // --------------------------
+
+    // Return every key that a function returns for the elements, paired with
+    // the elements that have that key
+    template<typename T>
+    template<typename Function>
+    Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, Collection<T>>>
+    Collection<T>::groupBy(Function key, int threads) const {
+        using key_type = typename std::decay<typename std::result_of<Function(T)>::type>::type;
+
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        // the groups grow on the worker pool, so they are kept on the heap
+        // rather than in the calling thread's arena, which isn't thread-safe
+        auto groups = aggregate_by_key<key_type, std::vector<T>>(Length,
+            [&](int i) { return key(static_cast<const T&>(Data[i])); },
+            [&](std::vector<T>& group, bool, int i) { group.push_back(Data[i]); },
+            [](std::vector<T>& into, std::vector<T>& from) {
+                into.insert(into.end(), from.begin(), from.end());
+            },
+            threads);
+
+        std::vector<std::pair<key_type, Collection<T>>> list;
+        list.reserve(groups.size());
+        bool in_arena = Arena::current() != nullptr;
+        for (auto& group : groups) {
+            auto& elements = group.second;
+            list.push_back(std::make_pair(std::move(group.first), in_arena ?
+                Collection<T>(buffer_vector<T>(elements.begin(), elements.end())) :
+                Collection<T>(std::move(elements))));
+        }
+        return list;
+    }
+
+    // Return every key that a function returns for the elements, paired with
+    // the number of elements that have it
+    template<typename T>
+    template<typename Function>
+    Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, int>>
+    Collection<T>::countBy(Function key, int threads) const {
+        using key_type = typename std::decay<typename std::result_of<Function(T)>::type>::type;
+
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        return aggregate_by_key<key_type, int>(Length,
+            [&](int i) { return key(static_cast<const T&>(Data[i])); },
+            [](int& count, bool, int) { count++; },
+            [](int& into, int from) { into += from; },
+            threads);
+    }
+
+    // Return every key that a function returns for the elements, paired with
+    // the result of combining the values of the elements with that key
+    template<typename T>
+    template<typename KeyFunction, typename ValueFunction, typename Combine>
+    Collection<std::pair<typename std::decay<typename std::result_of<KeyFunction(T)>::type>::type,
+                         typename std::decay<typename std::result_of<ValueFunction(T)>::type>::type>>
+    Collection<T>::reduceByKey(KeyFunction key, ValueFunction value, Combine combine, int threads) const {
+        using key_type = typename std::decay<typename std::result_of<KeyFunction(T)>::type>::type;
+        using value_type = typename std::decay<typename std::result_of<ValueFunction(T)>::type>::type;
+
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        return aggregate_by_key<key_type, value_type>(Length,
+            [&](int i) { return key(static_cast<const T&>(Data[i])); },
+            [&](value_type& val, bool fresh, int i) {
+                val = fresh ? value(Data[i]) : combine(val, value(Data[i]));
+            },
+            [&](value_type& into, value_type& from) { into = combine(into, from); },
+            threads);
+    }
+
+    // --------------------------
+    // SET OPERATIONS
+    // --------------------------
+
+    // Return the distinct elements that pass a predicate function, in the
+    // order they first appear
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Collection<T>::distinct_where(Function keep, int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        auto partitions = partition_by_key<T, int>(Length,
+            [&](int i) { return Data[i]; },
+            [](int& first, bool fresh, int i) {
+                if (fresh)
+                    first = i;
+            },
+            [](int& into, int from) { into = std::min(into, from); },
+            threads);
+
+        // the positions of the first appearances of the elements that are
+        // kept, found for every partition on its own
+        int parts = partitions.size();
+        std::vector<std::vector<int>> kept(parts);
+        thread_pool().parallel_for(0, parts, parts, threads,
+            [&](int, int begin, int end) {
+                for (int part = begin; part < end; part++)
+                    for (int i = 0; i < partitions[part].size(); i++) {
+                        auto& entry = partitions[part].entry(i);
+                        if (keep(static_cast<const T&>(entry.Key)))
+                            kept[part].push_back(entry.Value);
+                    }
+            });
+
+        std::vector<int> positions;
+        for (auto& part : kept)
+            positions.insert(positions.end(), part.begin(), part.end());
+        if (parts > 1)
+            sort_elements(positions.data(), positions.size(), threads, std::true_type());
+
+        Collection<T> result(positions.size());
+        T* list = result.Data;
+        for (int i = 0; i < result.Length; i++)
+            list[i] = Data[positions[i]];
+        return result;
+    }
+
+    // Return a hash set of the elements
+    template<typename T>
+    std::vector<HashTable<T, Unit>>
+    Collection<T>::hash_set(int threads) const {
+        advise(threads <= 1 ? Access::Sequential : Access::Parallel);
+        return partition_by_key<T, Unit>(Length,
+            [&](int i) { return Data[i]; },
+            [](Unit&, bool, int) {},
+            [](Unit&, Unit&) {},
+            threads);
+    }
+
+    // Return the elements without repeats, in the order they first appear
+    template<typename T>
+    Collection<T>
+    Collection<T>::distinct(int threads) const {
+        return distinct_where([](const T&) { return true; }, threads);
+    }
+
+    // Return the distinct elements that are also in another Collection
+    template<typename T>
+    Collection<T>
+    Collection<T>::intersect(const Collection<T>& other, int threads) const {
+        auto others = other.hash_set(threads);
+        return distinct_where([&](const T& x) { return partitions_contain(others, x); }, threads);
+    }
+
+    // Return the distinct elements of either Collection
+    template<typename T>
+    Collection<T>
+    Collection<T>::union_(const Collection<T>& other, int threads) const {
+        return concat(*this, other).distinct(threads);
+    }
+
+    // Return the distinct elements that aren't in another Collection
+    template<typename T>
+    Collection<T>
+    Collection<T>::diff(const Collection<T>& other, int threads) const {
+        auto others = other.hash_set(threads);
+        return distinct_where([&](const T& x) { return !partitions_contain(others, x); }, threads);
+    }
+
+    // --------------------------
+    // ZIPPED VIEWS
+    // --------------------------
+
+    // The result of zipping Collections. The columns are kept apart and share
+    // their elements with the zipped Collections, so zipping copies nothing.
+    // Functions passed to map, filter, foldLeft and each take one argument
+    // per column, so once they are inlined only the columns they use are
+    // read, in loops the compiler can vectorize.
+    template<typename ...U>
+    class ZippedView {
+    private:
+        using indices = typename make_index_list<sizeof...(U)>::type;
+
+        std::tuple<Collection<U>...> Columns;
+        int Length;
+
+        // Return the first element of every column
+        template<std::size_t ...I>
+        std::tuple<const U*...>
+        columns(index_list<I...>) const {
+            return std::tuple<const U*...>(std::get<I>(Columns).Data...);
+        };
+
+        // Return the elements at position 'index' of every column
+        template<std::size_t ...I>
+        std::tuple<const U&...>
+        row(int index, index_list<I...>) const {
+            return std::tuple<const U&...>(std::get<I>(Columns).Data[index]...);
+        };
+
+        template<typename Function, std::size_t ...I>
+        void
+        each(Function& func, index_list<I...>) const;
+
+        template<typename Function, std::size_t ...I>
+        Collection<typename std::result_of<Function(U...)>::type>
+        map(Function& func, index_list<I...>) const;
+
+        template<typename Function, std::size_t ...I>
+        ZippedView<U...>
+        filter(Function& func, index_list<I...>) const;
+
+        // Gather the elements at the given positions of a column
+        template<typename T>
+        static Collection<T>
+        gather(const T* data, const std::vector<int>& positions) {
+            int n = positions.size();
+            Collection<T> result(n);
+            T* list = result.Data;
+            for (int i = 0; i < n; i++)
+                list[i] = data[positions[i]];
+            return result;
+        };
+
+        template<typename Function, typename V, std::size_t ...I>
+        V
+        foldLeft(Function& func, V init, index_list<I...>) const;
+
+        template<std::size_t ...I>
+        ZippedView<U...>
+        slice(int low, int high, index_list<I...>) const;
+
+        template<std::size_t ...I>
+        void
+        save(const std::string& path, index_list<I...>) const;
+
+        template<std::size_t ...I>
+        static ZippedView<U...>
+        load(const std::string& path, bool verify, index_list<I...>);
+
+    public:
+
+        // Zip the columns, whose shortest length is used
+        ZippedView<U...>(const Collection<U>&... columns)
+            : Columns(columns...), Length(std::min({columns.Length...})) {};
+
+        // Return the elements at position 'index' of every column
+        std::tuple<const U&...>
+        operator[] (const int index) const {
+            return row(index, indices());
+        };
+
+        // Return the number of zipped rows
+        int
+        size() const {
+            return Length;
+        };
+
+        // Return the column at position I as a Collection
+        template<std::size_t I>
+        Collection<typename std::tuple_element<I, std::tuple<U...>>::type>
+        column() const {
+            return std::get<I>(Columns).slice(0, Length);
+        };
+
+        // Apply a function to the elements of every row
+        template<typename Function>
+        void
+        each(Function func) const {
+            each(func, indices());
+        };
+
+        // Return the Collection that results from the transformation of the
+        // elements of every row
+        template<typename Function>
+        Collection<typename std::result_of<Function(U...)>::type>
+        map(Function func) const {
+            return map(func, indices());
+        };
+
+        // Return the rows whose elements pass a predicate function, still
+        // kept as separate columns
+        template<typename Function>
+        ZippedView<U...>
+        filter(Function func) const {
+            return filter(func, indices());
+        };
+
+        // Return the result of the application of the same operator on an
+        // initial value and the elements of every row, starting from the left
+        template<typename Function, typename V>
+        V
+        foldLeft(Function func, V init) const {
+            return foldLeft(func, init, indices());
+        };
+
+        // Return the rows whose indices are within the range [low, high), as
+        // a view that shares the columns
+        ZippedView<U...>
+        slice(int low, int high) const {
+            return slice(low, high, indices());
+        };
+
+        // Return the rows as a Collection of tuples
+        Collection<std::tuple<U...>>
+        collect() const {
+            return map([](const U&... x) { return std::make_tuple(x...); });
+        };
+
+        // Convert to a Collection of tuples, the type zip used to return
+        operator Collection<std::tuple<U...>>() const {
+            return collect();
+        };
+
+        // Save the rows to a binary file, writing each column in one piece
+        void
+        save(const std::string& path) const {
+            save(path, indices());
+        };
+
+        // Return the rows saved to a binary file by save(), or by saving a
+        // Collection of tuples, with every column used in place from a
+        // mapping of the file
+        static ZippedView<U...>
+        load(const std::string& path, bool verify=false) {
+            return load(path, verify, indices());
+        };
+    };
+
+    // Save the rows to a binary file, writing each column in one piece
+    template<typename ...U>
+    template<std::size_t ...I>
+    void
+    ZippedView<U...>::save(const std::string& path, index_list<I...>) const {
+        StorageWriter writer(path, Length, {describe<U>()...});
+        int expand[] = {0, (writer.column(static_cast<const U*>(std::get<I>(Columns).Data)), 0)...};
+        (void) expand;
+        writer.close();
+    }
+
+    // Return the rows saved to a binary file, with every column used in place
+    // from a mapping of the file
+    template<typename ...U>
+    template<std::size_t ...I>
+    ZippedView<U...>
+    ZippedView<U...>::load(const std::string& path, bool verify, index_list<I...>) {
+        StoredFile file(path);
+        return ZippedView<U...>(Collection<U>::mapped(file.column<U>(I, verify), file.size())...);
+    }
+
+    // Apply a function to the elements of every row
+    template<typename ...U>
+    template<typename Function, std::size_t ...I>
+    void
+    ZippedView<U...>::each(Function& func, index_list<I...> indices) const {
+        auto data = columns(indices);
+        for (int i = 0; i < Length; i++)
+            func(std::get<I>(data)[i]...);
+    }
+
+    // Return the Collection that results from the transformation of the
+    // elements of every row
+    template<typename ...U>
+    template<typename Function, std::size_t ...I>
+    Collection<typename std::result_of<Function(U...)>::type>
+    ZippedView<U...>::map(Function& func, index_list<I...> indices) const {
+        using return_type = typename std::result_of<Function(U...)>::type;
+
+        auto data = columns(indices);
+        Collection<return_type> result(Length);
+        return_type* list = result.Data;
+        for (int i = 0; i < Length; i++)
+            list[i] = func(std::get<I>(data)[i]...);
+        return result;
+    }
+
+    // Return the rows whose elements pass a predicate function, still kept as
+    // separate columns
+    template<typename ...U>
+    template<typename Function, std::size_t ...I>
+    ZippedView<U...>
+    ZippedView<U...>::filter(Function& func, index_list<I...> indices) const {
+        auto data = columns(indices);
+        std::vector<int> positions;
+        for (int i = 0; i < Length; i++)
+            if (func(std::get<I>(data)[i]...))
+                positions.push_back(i);
+        return ZippedView<U...>(gather(std::get<I>(data), positions)...);
+    }
+
+    // Return the result of the application of the same operator on an initial
+    // value and the elements of every row, starting from the left
+    template<typename ...U>
+    template<typename Function, typename V, std::size_t ...I>
+    V
+    ZippedView<U...>::foldLeft(Function& func, V init, index_list<I...> indices) const {
+        using return_type = typename std::result_of<Function(V, U...)>::type;
+        static_assert(std::is_same<return_type, V>::value,
+            "Fold fn must return the same type as the initial value");
+
+        auto data = columns(indices);
+        V val = init;
+        for (int i = 0; i < Length; i++)
+            val = func(val, std::get<I>(data)[i]...);
+        return val;
+    }
+
+    // Return the rows whose indices are within the range [low, high), as a
+    // view that shares the columns
+    template<typename ...U>
+    template<std::size_t ...I>
+    ZippedView<U...>
+    ZippedView<U...>::slice(int low, int high, index_list<I...>) const {
+        // the columns may be longer than the view, so their own bounds are
+        // not enough
+        if (low < 0 || low > high || high > Length)
+            throw std::out_of_range("cannot slice rows [" + std::to_string(low) + ", " +
+                std::to_string(high) + ") of " + std::to_string(Length));
+        return ZippedView<U...>(std::get<I>(Columns).slice(low, high)...);
+    }
+
+    // --------------------------
+    // RANGES
+    // --------------------------
+
+    // The arithmetic sequence [low, low + length) returned by range(). Its
+    // elements are generated on the fly rather than stored, and sum, min, max
+    // and minmax are answered in constant time from the bounds. It converts
+    // to a Collection, and any Collection operation it doesn't implement
+    // itself runs on a materialized copy.
+    template<typename T>
+    class Range {
+    private:
+        T Low;
+        int Length;
+
+        // Return the element at position 'index'
+        T
+        value(int index) const {
+            return T(Low + index);
+        };
+
+        // Throw if there is no element for 'what' to return
+        void
+        require_elements(const char* what) const {
+            if (Length == 0)
+                throw std::length_error(std::string(what) + " of an empty Range");
+        };
+
+    public:
+        using value_type = T;
+
+        Range<T>(T low, int length) : Low(low), Length(std::max(0, length)) {};
+
+        // Overload the [] operator
+        T
+        operator[] (const int index) const {
+            return value(index);
+        };
+
+        // Overload the == operator
+        bool
+        operator==(const Range<T>& other) const {
+            return Length == other.Length && (Length == 0 || Low == other.Low);
+        };
+
+        // Compare with the elements of a Collection without materializing
+        bool
+        operator==(const Collection<T>& other) const {
+            if (Length != other.Length)
+                return false;
+            for (int i = 0; i < Length; i++)
+                if (!(value(i) == other.Data[i]))
+                    return false;
+            return true;
+        };
+
+        // Overload the << operator
+        friend std::ostream&
+        operator<<(std::ostream& stream, const Range<T>& r) {
+            return stream << r.materialize();
+        };
+
+        // Convert to a Collection holding every element
+        operator Collection<T>() const {
+            return materialize();
+        };
+
+        // Return a Collection holding every element
+        Collection<T>
+        materialize() const;
+
+        // Return the elements as a std::vector
+        std::vector<T>
+        vector() const {
+            std::vector<T> list(Length);
+            for (int i = 0; i < Length; i++)
+                list[i] = value(i);
+            return list;
+        };
+
+        // Return the elements as a std::list
+        std::list<T>
+        list() const {
+            return materialize().list();
+        };
+
+        // Return a lazy view of the Range, which generates the elements as
+        // its pipeline runs
+        LazyCollection<LazyRange<T>>
+        lazy() const {
+            return LazyRange<T>{Low, Length};
+        };
+
+        // Return the size of the Range
+        int
+        size() const {
+            return Length;
+        };
+
+        // Return the first element
+        T
+        head() const {
+            return Low;
+        };
+
+        // Return the last element
+        T
+        last() const {
+            require_elements("last");
+            return value(Length - 1);
+        };
+
+        // Return all the elements except the last
+        Range<T>
+        init() const {
+            return Range<T>(Low, Length - 1);
+        };
+
+        // Return all the elements except the head
+        Range<T>
+        tail() const {
+            return Range<T>(value(1), Length - 1);
+        };
+
+        // Return the elements whose indices are within the range [low, high)
+        Range<T>
+        slice(int low, int high) const {
+            return Range<T>(value(low), high - low);
+        };
+
+        // Apply a function to all the elements
+        template<typename Function>
+        void
+        each(Function func) const {
+            for (int i = 0; i < Length; i++)
+                func(value(i));
+        };
+
+        // Return the elements that pass a predicate function
+        template<typename Function>
+        Collection<T>
+        filter(Function func) const;
+
+        // Return the Collection that results from the transformation of each
+        // element
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        map(Function func) const;
+
+        // Return the transformed elements in a binary file created at 'path',
+        // writing them through a shared memory mapping of the file
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        map(Function func, const std::string& path) const;
+
+        // An alternative implementation of map that generates and transforms
+        // chunks of the Range on the shared worker pool
+        template<typename Function>
+        Collection<typename std::result_of<Function(T)>::type>
+        tmap(Function func, int threads=detectedThreads) const;
+
+        // Return the result of the application of the same binary operator on
+        // adjacent pairs of elements, starting from the left
+        template<typename Function>
+        T
+        reduceLeft(Function func) const {
+            // TODO: bounds checking
+            T val = func(value(0), value(1));
+            for (int i = 2; i < Length; i++)
+                val = func(val, value(i));
+            return val;
+        };
+
+        // Return the result of the application of the same binary operator on
+        // all elements as well as an initial value, starting from the left
+        template<typename Function, typename U>
+        typename std::result_of<Function(U, T)>::type
+        foldLeft(Function func, U init) const {
+            using return_type = typename std::result_of<Function(U, T)>::type;
+            static_assert(std::is_same<return_type, U>::value,
+                "Fold fn must return the same type as the initial value");
+
+            return_type val = init;
+            for (int i = 0; i < Length; i++)
+                val = func(val, value(i));
+            return val;
+        };
+
+        // Return the sum of the elements in constant time
+        T
+        sum() const;
+
+        // Return the smallest element in constant time
+        T
+        min() const {
+            require_elements("min");
+            return Low;
+        };
+
+        // Return the largest element in constant time
+        T
+        max() const {
+            require_elements("max");
+            return value(Length - 1);
+        };
+
+        // Return the smallest and the largest element in constant time
+        std::pair<T, T>
+        minmax() const {
+            require_elements("minmax");
+            return std::make_pair(Low, value(Length - 1));
+        };
+
+        // Return the number of elements that pass a predicate function,
+        // generating and testing chunks of the Range on the shared worker
+        // pool with more than one thread
+        template<typename Function>
+        int
+        count(Function func, int threads=1) const;
+
+        // The remaining operations run on a materialized Collection
+
+        template<typename Function>
+        T
+        reduceRight(Function func) const {
+            return materialize().reduceRight(func);
+        };
+
+        template<typename Function>
+        T
+        treduce(Function func, int threads=detectedThreads) const {
+            return materialize().treduce(func, threads);
+        };
+
+        template<typename Function>
+        Collection<T>
+        tfilter(Function func, int threads=detectedThreads) const {
+            return materialize().tfilter(func, threads);
+        };
+
+        template<typename U, typename SeqOp, typename CombOp>
+        U
+        aggregate(U init, SeqOp seqOp, CombOp combOp, int threads=detectedThreads) const {
+            return materialize().aggregate(init, seqOp, combOp, threads);
+        };
+
+        template<typename Function, typename U>
+        typename std::result_of<Function(U, T)>::type
+        foldRight(Function func, U init) const {
+            return materialize().foldRight(func, init);
+        };
+
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        scanLeft(Function func, U init) const {
+            return materialize().scanLeft(func, init);
+        };
+
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        scanRight(Function func, U init) const {
+            return materialize().scanRight(func, init);
+        };
+
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        tscanLeft(Function func, U init, int threads=detectedThreads) const {
+            return materialize().tscanLeft(func, init, threads);
+        };
+
+        template<typename Function, typename U>
+        Collection<typename std::result_of<Function(U, T)>::type>
+        tscanRight(Function func, U init, int threads=detectedThreads) const {
+            return materialize().tscanRight(func, init, threads);
+        };
+
+        // A Range is already in ascending order
+        Collection<T>
+        sort() const {
+            return materialize();
+        };
+
+        template<typename Function>
+        Collection<T>
+        sortBy(Function key, int threads=detectedThreads) const {
+            return materialize().sortBy(key, threads);
+        };
+
+        template<typename Function>
+        Collection<T>
+        stableSortBy(Function key, int threads=detectedThreads) const {
+            return materialize().stableSortBy(key, threads);
+        };
+
+        template<typename Function>
+        Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, Collection<T>>>
+        groupBy(Function key, int threads=1) const {
+            return materialize().groupBy(key, threads);
+        };
+
+        template<typename Function>
+        Collection<std::pair<typename std::decay<typename std::result_of<Function(T)>::type>::type, int>>
+        countBy(Function key, int threads=1) const {
+            return materialize().countBy(key, threads);
+        };
+
+        template<typename KeyFunction, typename ValueFunction, typename Combine>
+        Collection<std::pair<typename std::decay<typename std::result_of<KeyFunction(T)>::type>::type,
+                             typename std::decay<typename std::result_of<ValueFunction(T)>::type>::type>>
+        reduceByKey(KeyFunction key, ValueFunction value, Combine combine, int threads=1) const {
+            return materialize().reduceByKey(key, value, combine, threads);
+        };
+
+        // A Range has no repeats
+        Collection<T>
+        distinct() const {
+            return materialize();
+        };
+
+        Collection<T>
+        intersect(const Collection<T>& other, int threads=1) const {
+            return materialize().intersect(other, threads);
+        };
+
+        Collection<T>
+        union_(const Collection<T>& other, int threads=1) const {
+            return materialize().union_(other, threads);
+        };
+
+        Collection<T>
+        diff(const Collection<T>& other, int threads=1) const {
+            return materialize().diff(other, threads);
+        };
+    };
+
+    // Return a Collection holding every element
+    template<typename T>
+    Collection<T>
+    Range<T>::materialize() const {
+        Collection<T> result(Length);
+        T* list = result.Data;
+        for (int i = 0; i < Length; i++)
+            list[i] = value(i);
+        return result;
+    }
+
+    // Return the elements that pass a predicate function
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Range<T>::filter(Function func) const {
+        // the survivors of a small Range fit inline
+        if (Length <= inline_capacity<T>::value) {
+            Collection<T> result;
+            for (int i = 0; i < Length; i++)
+                if (func(value(i)))
+                    result.Data[result.Length++] = value(i);
+            return result;
+        }
+
+        buffer_vector<T> list;
+        for (int i = 0; i < Length; i++)
+            if (func(value(i)))
+                list.push_back(value(i));
+        return Collection<T>(std::move(list));
+    }
+
+    // Return the Collection that results from the transformation of each
+    // element
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Range<T>::map(Function func) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        Collection<return_type> result(Length);
+        return_type* list = result.Data;
+        for (int i = 0; i < Length; i++)
+            list[i] = func(value(i));
+        return result;
+    }
+
+    // Return the transformed elements in a binary file created at 'path',
+    // writing them through a shared memory mapping of the file
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Range<T>::map(Function func, const std::string& path) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        auto result = Collection<return_type>::mapped(
+            create_file<return_type>(path, Length), Length);
+        return_type* list = result.Data;
+        for (int i = 0; i < Length; i++)
+            list[i] = func(value(i));
+        return result;
+    }
+
+    // An alternative implementation of map that generates and transforms
+    // chunks of the Range on the shared worker pool
+    template<typename T>
+    template<typename Function>
+    Collection<typename std::result_of<Function(T)>::type>
+    Range<T>::tmap(Function func, int threads) const {
+        using return_type = typename std::result_of<Function(T)>::type;
+
+        Collection<return_type> result(Length);
+        return_type* list = result.Data;
+        thread_pool().parallel_for(0, Length, parallel_chunks(Length, threads), threads,
+            [&](int, int begin, int end) {
+                for (int i = begin; i < end; i++)
+                    list[i] = func(value(i));
+            });
+        return result;
+    }
+
+    // Return the number of elements that pass a predicate function
+    template<typename T>
+    template<typename Function>
+    int
+    Range<T>::count(Function func, int threads) const {
+        if (threads <= 1) {
+            int val = 0;
+            for (int i = 0; i < Length; i++)
+                val += func(value(i)) ? 1 : 0;
+            return val;
+        }
+
+        int chunks = parallel_chunks(Length, threads);
+        std::vector<int> results(chunks, 0);
+        thread_pool().parallel_for(0, Length, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                int val = 0;
+                for (int i = begin; i < end; i++)
+                    val += func(value(i)) ? 1 : 0;
+                results[chunk] = val;
+            });
+
+        int val = 0;
+        for (int i = 0; i < chunks; i++)
+            val += results[i];
+        return val;
+    }
+
+    // Return the sum of the elements in constant time, from the number of
+    // elements and the mean of the first and the last
+    template<typename T>
+    T
+    Range<T>::sum() const {
+        using wide_type = typename std::conditional<std::is_integral<T>::value,
+            long long, long double>::type;
+
+        wide_type n = Length;
+        return T(n * wide_type(Low) + n * (n - 1) / 2);
     }
 
     // --------------------------
@@ -475,88 +2262,77 @@ namespace cpp_collections {
 
     template<typename T>
     void
-    concat_helper(std::vector<T>& list, Collection<T>& other_list, int& index) {
+    concat_helper(T* list, const Collection<T>& other_list, int& index) {
         for (int i = 0; i < other_list.size(); i++)
             list[index++] = other_list[i];
     }
 
-    // Concatenate an arbitrary number of Collections
-    template<typename T, typename ...Collections>
-    Collection<T>
-    concat(Collection<T>& original, Collections... other_list) {
+    template<typename T>
+    void
+    concat_helper(T* list, const Range<T>& other_list, int& index) {
+        for (int i = 0; i < other_list.size(); i++)
+            list[index++] = other_list[i];
+    }
+
+    // Concatenate an arbitrary number of Collections or Ranges
+    template<typename C, typename ...Collections>
+    Collection<typename collection_value<C>::type>
+    concat(const C& original, const Collections&... other_list) {
         // TODO: Check that all arguments are Collections of the same type with
         // a static_assert. However, note that this check is already being made
         // implicitly by concat_helper 
+        using T = typename collection_value<C>::type;
+
         int size = original.size();
         int get_size[]{0, (size += other_list.size(), 0)...};
-        std::vector<T> list(size);
+        Collection<T> result(size);
+        T* list = result.Data;
 
         int index = 0;
         concat_helper(list, original, index);
         int concatenate[]{0, (concat_helper(list, other_list, index), 0)...};
-        return Collection<T>(list);
+        return result;
     }
 
-    // Return Collection of numeric types over the range [0, size)
+    // Return a Range of numeric types over the range [0, size), which
+    // generates its elements rather than storing them
     template<typename T>
-    const Collection<T>
+    Range<T>
     range(T size) {
         static_assert(std::is_arithmetic<T>::value,
             "You must pass range arithmetic type parameters");
 
-        std::vector<T> v(size);
-        for (int i = 0; i < size; i++)
-            v[i] = T(i);
-
-        const auto tmp = Collection<T>(v);
-        return tmp;
+        return Range<T>(T(0), size);
     }
 
-    // Return Collection of numeric types over the range [low, high)
+    // Return a Range of numeric types over the range [low, high), which
+    // generates its elements rather than storing them
     template<typename T>
-    const Collection<T>
+    Range<T>
     range(T low, T high) {
         static_assert(std::is_arithmetic<T>::value,
             "You must pass range arithmetic type parameters");
 
-        std::vector<T> v(high-low);
-        for (int i = 0; i < high-low; i++)
-            v[i] = T(low + i);
-
-        const auto tmp = Collection<T>(v);
-        return tmp;
+        return Range<T>(low, high-low);
     }
 
 
-    // Return a Collection of tuples, where each tuple contains the elements of
-    // the zipped lists that occur at the same position
-    template<typename ...U>
-    Collection<std::tuple<U...>>
-    zip(Collection<U>&... other_list) {
-        // TODO: list size checking
-        using return_type = std::tuple<U...>;
-
-        std::vector<return_type> list(std::min({other_list.size()...}));
-        for (int i = 0; i < list.size(); i++) {
-            list[i] = std::make_tuple(other_list[i]...);
-        }
-        return Collection<return_type>(list);
+    // Return a view of tuples, where each tuple contains the elements of the
+    // zipped lists that occur at the same position. The lists are kept as
+    // separate columns rather than copied.
+    template<typename ...C>
+    ZippedView<typename collection_value<C>::type...>
+    zip(const C&... other_list) {
+        return ZippedView<typename collection_value<C>::type...>(other_list...);
     }
 
     // Generalizes zip by zipping with the function given as the first argument
     // instead of a tupling function
-    template<typename Function, typename ...U>
-    Collection<typename std::result_of<Function(U...)>::type>
-    zipWith(Function func, Collection<U>&... other_list) {
-        // TODO: list size checking
+    template<typename Function, typename ...C>
+    Collection<typename std::result_of<Function(typename collection_value<C>::type...)>::type>
+    zipWith(Function func, const C&... other_list) {
         // TODO: check that func takes as many arguments as there are lists
-        using return_type = typename std::result_of<Function(U...)>::type;
-
-        std::vector<return_type> list(std::min({other_list.size()...}));
-        for (int i = 0; i < list.size(); i++) {
-            list[i] = func(other_list[i]...);
-        }
-        return Collection<return_type>(list);
+        return zip(other_list...).map(func);
     }
 }
 
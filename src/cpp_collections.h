@@ -3,5 +3,8 @@
 
 #include "collections.h"
 #include "streams.h"
+#include "chunked.h"
+#include "chunked_stream.h"
+#include "lazy_stream.h"
 
 #endif
@@ -0,0 +1,275 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace cpp_collections {
+
+    // --------------------------
+    // HASH TABLES
+    // --------------------------
+
+    // Spread the bits of a hash, since std::hash of an integer is the
+    // integer itself and would cluster in a table indexed by its low bits
+    inline uint64_t
+    mix_hash(uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94d049bb133111ebULL;
+        return hash ^ (hash >> 31);
+    }
+
+    // An open addressing hash table with linear probing. The entries are
+    // kept in the order their keys were first inserted, and the slots only
+    // hold the position of an entry with a few bits of its hash, so empty
+    // slots cost eight bytes and no key or value is ever constructed for
+    // them. Most probes that don't match are rejected by those bits without
+    // reading the entry.
+    template<typename K, typename V, typename Hasher = std::hash<K>>
+    class HashTable {
+    public:
+        struct Entry {
+            K Key;
+            V Value;
+            uint64_t Hash;
+        };
+
+    private:
+        struct Slot {
+            // the top half of the entry's hash, zero in an empty slot
+            uint32_t Check;
+            int Position;
+        };
+
+        // a power of two number of slots, at most a quarter of them used
+        std::vector<Slot> Slots;
+        std::vector<Entry> Entries;
+
+        // Return the bits of a hash that a slot keeps, which are never zero
+        static uint32_t
+        check(uint64_t hash) {
+            return uint32_t(hash >> 32);
+        };
+
+        // Rebuild the slots with 'count' of them
+        void
+        rehash(std::size_t count);
+
+    public:
+
+        // Return the mixed hash of a key, which is never zero
+        static uint64_t
+        hash(const K& key) {
+            return mix_hash(Hasher()(key)) | (uint64_t(1) << 63);
+        };
+
+        // Make room for 'n' entries without rehashing
+        void
+        reserve(int n);
+
+        // Return the value of 'key', whose hash is 'hash', and whether it was
+        // just inserted with a default constructed value. The reference is
+        // valid until the next insertion.
+        std::pair<V*, bool>
+        emplace(const K& key, uint64_t hash);
+
+        // Return the value of 'key', whose hash is 'hash', or null when it is
+        // missing. Any number of threads may look keys up at once.
+        const V*
+        find(const K& key, uint64_t hash) const;
+
+        // Return the value of 'key', or null when it is missing
+        const V*
+        find(const K& key) const {
+            return find(key, hash(key));
+        };
+
+        // Return the number of entries
+        int
+        size() const {
+            return Entries.size();
+        };
+
+        // Return the entry whose key was inserted 'index'th
+        Entry&
+        entry(int index) {
+            return Entries[index];
+        };
+    };
+
+    // Rebuild the slots with 'count' of them, a power of two
+    template<typename K, typename V, typename Hasher>
+    void
+    HashTable<K, V, Hasher>::rehash(std::size_t count) {
+        std::vector<Slot> slots(count, Slot{0, 0});
+        std::size_t mask = count - 1;
+        for (int i = 0; i < size(); i++) {
+            std::size_t slot = Entries[i].Hash & mask;
+            while (slots[slot].Check != 0)
+                slot = (slot + 1) & mask;
+            slots[slot] = Slot{check(Entries[i].Hash), i};
+        }
+        Slots.swap(slots);
+    }
+
+    // Make room for 'n' entries without rehashing
+    template<typename K, typename V, typename Hasher>
+    void
+    HashTable<K, V, Hasher>::reserve(int n) {
+        Entries.reserve(n);
+        std::size_t count = Slots.empty() ? 16 : Slots.size();
+        while (count < 4 * std::size_t(n))
+            count *= 2;
+        if (count != Slots.size())
+            rehash(count);
+    }
+
+    // Return the value of 'key' and whether it was just inserted
+    template<typename K, typename V, typename Hasher>
+    std::pair<V*, bool>
+    HashTable<K, V, Hasher>::emplace(const K& key, uint64_t hash) {
+        if (4 * (Entries.size() + 1) > Slots.size())
+            rehash(Slots.empty() ? 16 : 2 * Slots.size());
+
+        std::size_t mask = Slots.size() - 1;
+        uint32_t bits = check(hash);
+        for (std::size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+            Slot& s = Slots[slot];
+            if (s.Check == bits) {
+                Entry& entry = Entries[s.Position];
+                if (entry.Hash == hash && entry.Key == key)
+                    return std::make_pair(&entry.Value, false);
+            }
+            if (s.Check == 0) {
+                s = Slot{bits, size()};
+                Entries.push_back(Entry{key, V(), hash});
+                return std::make_pair(&Entries.back().Value, true);
+            }
+        }
+    }
+
+    // Return the value of 'key', whose hash is 'hash', or null when it is missing
+    template<typename K, typename V, typename Hasher>
+    const V*
+    HashTable<K, V, Hasher>::find(const K& key, uint64_t hash) const {
+        if (Slots.empty())
+            return nullptr;
+
+        std::size_t mask = Slots.size() - 1;
+        uint32_t bits = check(hash);
+        for (std::size_t slot = hash & mask; Slots[slot].Check != 0; slot = (slot + 1) & mask)
+            if (Slots[slot].Check == bits) {
+                const Entry& entry = Entries[Slots[slot].Position];
+                if (entry.Hash == hash && entry.Key == key)
+                    return &entry.Value;
+            }
+        return nullptr;
+    }
+
+    // The value of a table that only holds keys, as a hash set
+    struct Unit {};
+
+    // Return which of 'parts' partitions a hash belongs to
+    inline int
+    hash_partition(uint64_t hash, int parts) {
+        return (hash >> 40) % parts;
+    }
+
+    // Aggregate 'n' elements by key into one table per partition of the key
+    // hashes: key(i) returns the key of element i, add(value, fresh, i) adds
+    // element i to the value of its key, which is default constructed when
+    // 'fresh', and merge(into, from) combines two values of the same key.
+    // With one thread there is a single table, whose keys are in the order
+    // they first appear. With more, every chunk of elements aggregates into a
+    // table per partition on the shared worker pool, and then each partition
+    // merges its tables from all chunks on its own, so no table is shared
+    // between threads. There is a partition per thread, and each merged
+    // table is sized up front from the entries its chunks found.
+    template<typename K, typename V, typename Key, typename Add, typename Merge>
+    std::vector<HashTable<K, V>>
+    partition_by_key(int n, Key key, Add add, Merge merge, int threads) {
+        using table = HashTable<K, V>;
+        std::vector<table> partitions;
+
+        if (threads <= 1) {
+            partitions.resize(1);
+            for (int i = 0; i < n; i++) {
+                K k = key(i);
+                auto value = partitions[0].emplace(k, table::hash(k));
+                add(*value.first, value.second, i);
+            }
+            return partitions;
+        }
+
+        int chunks = parallel_chunks(n, threads);
+        int parts = std::min(chunks, threads);
+        std::vector<std::vector<table>> local(chunks, std::vector<table>(parts));
+        thread_pool().parallel_for(0, n, chunks, threads,
+            [&](int chunk, int begin, int end) {
+                auto& tables = local[chunk];
+                for (int i = begin; i < end; i++) {
+                    K k = key(i);
+                    uint64_t h = table::hash(k);
+                    auto value = tables[hash_partition(h, parts)].emplace(k, h);
+                    add(*value.first, value.second, i);
+                }
+            });
+
+        partitions.resize(parts);
+        thread_pool().parallel_for(0, parts, parts, threads,
+            [&](int, int begin, int end) {
+                for (int part = begin; part < end; part++) {
+                    int entries = 0;
+                    for (int chunk = 0; chunk < chunks; chunk++)
+                        entries += local[chunk][part].size();
+                    table& merged = partitions[part];
+                    merged = std::move(local[0][part]);
+                    merged.reserve(entries);
+                    for (int chunk = 1; chunk < chunks; chunk++)
+                        for (int i = 0; i < local[chunk][part].size(); i++) {
+                            auto& entry = local[chunk][part].entry(i);
+                            auto value = merged.emplace(entry.Key, entry.Hash);
+                            if (value.second)
+                                *value.first = std::move(entry.Value);
+                            else
+                                merge(*value.first, entry.Value);
+                        }
+                }
+            });
+        return partitions;
+    }
+
+    // Return whether a key is in any of the tables partition_by_key returned
+    template<typename K, typename V>
+    bool
+    partitions_contain(const std::vector<HashTable<K, V>>& partitions, const K& key) {
+        uint64_t h = HashTable<K, V>::hash(key);
+        return partitions[hash_partition(h, partitions.size())].find(key, h) != nullptr;
+    }
+
+    // Aggregate 'n' elements by key as partition_by_key does, and return
+    // every key with its value. With more than one thread the keys come out
+    // grouped by partition instead of in the order they first appear.
+    template<typename K, typename V, typename Key, typename Add, typename Merge>
+    std::vector<std::pair<K, V>>
+    aggregate_by_key(int n, Key key, Add add, Merge merge, int threads) {
+        auto partitions = partition_by_key<K, V>(n, key, add, merge, threads);
+        std::vector<std::pair<K, V>> result;
+        for (auto& part : partitions)
+            for (int i = 0; i < part.size(); i++) {
+                auto& entry = part.entry(i);
+                result.push_back(std::make_pair(std::move(entry.Key), std::move(entry.Value)));
+            }
+        return result;
+    }
+}
+
+#endif
@@ -0,0 +1,340 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace cpp_collections {
+
+    template<typename T>
+    class Collection;
+
+    template<typename T>
+    class Range;
+
+    // --------------------------
+    // PIPELINE STAGES
+    // --------------------------
+
+    // Every stage pushes its elements, in order, into a sink: a callable that
+    // takes one element and returns false once it wants no more. run()
+    // returns false if the sink stopped early. Stages are nested by value, so
+    // a whole pipeline compiles down to one loop over the source.
+
+    // The elements of a Collection, whose buffer may be kept alive by the
+    // stage
+    template<typename T>
+    struct LazySource {
+        using value_type = T;
+        static const bool exact = true;
+
+        const T* Begin;
+        int Length;
+        std::shared_ptr<const T> Owner;
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            for (int i = 0; i < Length; i++)
+                if (!sink(Begin[i]))
+                    return false;
+            return true;
+        };
+
+        // Upper bound on the number of elements produced
+        int
+        bound() const {
+            return Length;
+        };
+    };
+
+    // The arithmetic sequence of a Range, generated as the pipeline runs
+    template<typename T>
+    struct LazyRange {
+        using value_type = T;
+        static const bool exact = true;
+
+        T Low;
+        int Length;
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            for (int i = 0; i < Length; i++)
+                if (!sink(T(Low + i)))
+                    return false;
+            return true;
+        };
+
+        int
+        bound() const {
+            return Length;
+        };
+    };
+
+    template<typename Prev, typename Function>
+    struct LazyMap {
+        using value_type = typename std::decay<
+            typename std::result_of<Function(typename Prev::value_type)>::type>::type;
+        static const bool exact = Prev::exact;
+
+        Prev Source;
+        Function Func;
+
+        template<typename Sink>
+        struct MapSink {
+            Sink& Next;
+            const Function& Func;
+
+            bool
+            operator()(const typename Prev::value_type& x) {
+                return Next(Func(x));
+            };
+        };
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            return Source.run(MapSink<Sink>{sink, Func});
+        };
+
+        int
+        bound() const {
+            return Source.bound();
+        };
+    };
+
+    template<typename Prev, typename Function>
+    struct LazyFilter {
+        using value_type = typename Prev::value_type;
+        static const bool exact = false;
+
+        Prev Source;
+        Function Func;
+
+        template<typename Sink>
+        struct FilterSink {
+            Sink& Next;
+            const Function& Func;
+
+            bool
+            operator()(const value_type& x) {
+                return !Func(x) || Next(x);
+            };
+        };
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            return Source.run(FilterSink<Sink>{sink, Func});
+        };
+
+        int
+        bound() const {
+            return Source.bound();
+        };
+    };
+
+    template<typename Prev>
+    struct LazySlice {
+        using value_type = typename Prev::value_type;
+        static const bool exact = Prev::exact;
+
+        Prev Source;
+        int Low;
+        int High;
+
+        template<typename Sink>
+        struct SliceSink {
+            Sink& Next;
+            int Low;
+            int High;
+            int Index;
+
+            bool
+            operator()(const value_type& x) {
+                int i = Index++;
+                if (i < Low)
+                    return true;
+                return i < High && Next(x) && i + 1 < High;
+            };
+        };
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            if (High <= Low)
+                return true;
+            return Source.run(SliceSink<Sink>{sink, Low, High, 0});
+        };
+
+        int
+        bound() const {
+            return std::max(0, std::min(Source.bound(), High) - Low);
+        };
+    };
+
+    template<typename Prev, typename Function, typename U>
+    struct LazyZipWith {
+        using value_type = typename std::decay<
+            typename std::result_of<Function(typename Prev::value_type, U)>::type>::type;
+        static const bool exact = Prev::exact;
+
+        Prev Source;
+        Function Func;
+        LazySource<U> Other;
+
+        template<typename Sink>
+        struct ZipWithSink {
+            Sink& Next;
+            const Function& Func;
+            const LazySource<U>& Other;
+            int Index;
+
+            bool
+            operator()(const typename Prev::value_type& x) {
+                if (Index >= Other.Length)
+                    return false;
+                return Next(Func(x, Other.Begin[Index++]));
+            };
+        };
+
+        template<typename Sink>
+        bool
+        run(Sink&& sink) const {
+            return Source.run(ZipWithSink<Sink>{sink, Func, Other, 0});
+        };
+
+        int
+        bound() const {
+            return std::min(Source.bound(), Other.Length);
+        };
+    };
+
+    // --------------------------
+    // LAZY COLLECTION
+    // --------------------------
+
+    // A view over a Collection whose intermediate operations are recorded
+    // rather than run. Nothing is computed until a terminal operation, which
+    // runs every recorded stage in a single pass without allocating the
+    // intermediate Collections.
+    template<typename Stage>
+    class LazyCollection {
+    private:
+        Stage Pipeline;
+    public:
+        using value_type = typename Stage::value_type;
+
+        LazyCollection<Stage>(Stage stage) : Pipeline(stage) {};
+
+        // Return the recorded pipeline
+        const Stage&
+        stage() const {
+            return Pipeline;
+        };
+
+        // Record the transformation of each element
+        template<typename Function>
+        LazyCollection<LazyMap<Stage, Function>>
+        map(Function func) const {
+            return LazyMap<Stage, Function>{Pipeline, func};
+        };
+
+        // Record a predicate that elements must pass
+        template<typename Function>
+        LazyCollection<LazyFilter<Stage, Function>>
+        filter(Function func) const {
+            return LazyFilter<Stage, Function>{Pipeline, func};
+        };
+
+        // Record that only the elements with indices in [low, high) are kept
+        LazyCollection<LazySlice<Stage>>
+        slice(int low, int high) const {
+            return LazySlice<Stage>{Pipeline, low, high};
+        };
+
+        // Record zipping each element with the element of 'other' at the same
+        // position using func. The view shares or copies the elements of
+        // 'other', so 'other' may be a temporary.
+        template<typename Function, typename U>
+        LazyCollection<LazyZipWith<Stage, Function, U>>
+        zipWith(Function func, const Collection<U>& other) const {
+            return LazyZipWith<Stage, Function, U>{Pipeline, func,
+                Collection<U>(other).lazy().stage()};
+        };
+
+        // Record zipping each element with the element of a Range at the same
+        // position using func
+        template<typename Function, typename U>
+        LazyCollection<LazyZipWith<Stage, Function, U>>
+        zipWith(Function func, const Range<U>& other) const {
+            return LazyZipWith<Stage, Function, U>{Pipeline, func,
+                Collection<U>(other).lazy().stage()};
+        };
+
+        // Run the pipeline, applying a function to every element
+        template<typename Function>
+        void
+        each(Function func) const {
+            Pipeline.run([&](const value_type& x) {
+                func(x);
+                return true;
+            });
+        };
+
+        // Run the pipeline, reducing its elements from the left
+        template<typename Function>
+        value_type
+        reduceLeft(Function func) const {
+            // TODO: bounds checking
+            bool first = true;
+            value_type val = value_type();
+            Pipeline.run([&](const value_type& x) {
+                val = first ? x : func(val, x);
+                first = false;
+                return true;
+            });
+            return val;
+        };
+
+        // Run the pipeline, folding its elements from the left into init
+        template<typename Function, typename U>
+        typename std::result_of<Function(U, value_type)>::type
+        foldLeft(Function func, U init) const {
+            using return_type = typename std::result_of<Function(U, value_type)>::type;
+            static_assert(std::is_same<return_type, U>::value,
+                "Fold fn must return the same type as the initial value");
+
+            return_type val = init;
+            Pipeline.run([&](const value_type& x) {
+                val = func(val, x);
+                return true;
+            });
+            return val;
+        };
+
+        // Run the pipeline into a std::vector
+        std::vector<value_type>
+        vector() const {
+            std::vector<value_type> list;
+            if (Stage::exact)
+                list.reserve(Pipeline.bound());
+            Pipeline.run([&](const value_type& x) {
+                list.push_back(x);
+                return true;
+            });
+            return list;
+        };
+
+        // Run the pipeline into a Collection
+        Collection<value_type>
+        collect() const {
+            return Collection<value_type>(vector());
+        };
+    };
+}
+
+#endif
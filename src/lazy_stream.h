@@ -0,0 +1,369 @@
+#ifndef LAZY_STREAM_H
+#define LAZY_STREAM_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "utility.h"
+#include "collections.h"
+#include "streams.h"
+
+namespace cpp_collections {
+
+    // --------------------------
+    // STREAM STAGES
+    // --------------------------
+
+    // Every stage produces its elements one at a time: next() returns the
+    // current element and advances the stage. Streams never end, so next()
+    // always has an element. Unlike the stages of a LazyCollection, which
+    // push their elements into a sink, stream stages are pulled, so that
+    // several of them can be zipped and a pipeline can be stopped and resumed
+    // as a Stream. Stages are nested by value, so a whole pipeline compiles
+    // down to one loop in take().
+
+    // n, n + step, n + 2 * step, and so on
+    template<typename T>
+    struct StreamFrom {
+        using value_type = T;
+
+        T Next;
+        T Step;
+
+        T
+        next() {
+            T x = Next;
+            Next = T(Next + Step);
+            return x;
+        };
+    };
+
+    // The return values from repeated calls to a function
+    template<typename Function>
+    struct StreamGenerate {
+        using value_type = typename std::decay<typename std::result_of<Function()>::type>::type;
+
+        Function Func;
+
+        value_type
+        next() {
+            return Func();
+        };
+    };
+
+    template<typename T>
+    struct StreamRepeat {
+        using value_type = T;
+
+        T Value;
+
+        T
+        next() {
+            return Value;
+        };
+    };
+
+    // x, f(x), f(f(x)), and so on, calling f only once the next element is
+    // asked for
+    template<typename T, typename Function>
+    struct StreamIterate {
+        using value_type = T;
+
+        T Value;
+        Function Func;
+        bool Started;
+
+        T
+        next() {
+            if (Started)
+                Value = Func(Value);
+            Started = true;
+            return Value;
+        };
+    };
+
+    template<typename Prev, typename Function>
+    struct StreamMap {
+        using value_type = typename std::decay<
+            typename std::result_of<Function(typename Prev::value_type)>::type>::type;
+
+        Prev Source;
+        Function Func;
+
+        value_type
+        next() {
+            return Func(Source.next());
+        };
+    };
+
+    template<typename Prev, typename Function>
+    struct StreamFilter {
+        using value_type = typename Prev::value_type;
+
+        Prev Source;
+        Function Func;
+
+        value_type
+        next() {
+            while (true) {
+                value_type x = Source.next();
+                if (Func(x))
+                    return x;
+            }
+        };
+    };
+
+    template<typename Function, typename ...Prev>
+    struct StreamZipWith {
+        using value_type = typename std::decay<
+            typename std::result_of<Function(typename Prev::value_type...)>::type>::type;
+
+        Function Func;
+        std::tuple<Prev...> Sources;
+
+        template<std::size_t ...I>
+        value_type
+        next(index_list<I...>) {
+            return Func(std::get<I>(Sources).next()...);
+        };
+
+        value_type
+        next() {
+            return next(typename make_index_list<sizeof...(Prev)>::type());
+        };
+    };
+
+    // The elements after the first n of another stage
+    template<typename Prev>
+    struct StreamDrop {
+        using value_type = typename Prev::value_type;
+
+        Prev Source;
+        int Count;
+
+        value_type
+        next() {
+            for (; Count > 0; Count--)
+                Source.next();
+            return Source.next();
+        };
+    };
+
+    // An input iterator over the elements a stage produces. Copies of the
+    // iterator share the stage, which is null at the end.
+    template<typename Gen>
+    class StreamStageIterator {
+    private:
+        std::shared_ptr<Gen> Generator;
+        typename Gen::value_type Current;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename Gen::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        StreamStageIterator<Gen>() {};
+
+        StreamStageIterator<Gen>(const Gen& gen)
+            : Generator(std::make_shared<Gen>(gen)), Current(Generator->next()) {};
+
+        const value_type&
+        operator*() const {
+            return Current;
+        };
+
+        const value_type*
+        operator->() const {
+            return &Current;
+        };
+
+        StreamStageIterator<Gen>&
+        operator++() {
+            Current = Generator->next();
+            return *this;
+        };
+
+        StreamStageIterator<Gen>
+        operator++(int) {
+            StreamStageIterator<Gen> previous = *this;
+            ++*this;
+            return previous;
+        };
+
+        bool
+        operator==(const StreamStageIterator<Gen>& other) const {
+            return Generator == other.Generator;
+        };
+
+        bool
+        operator!=(const StreamStageIterator<Gen>& other) const {
+            return Generator != other.Generator;
+        };
+    };
+
+    // Return the elements a stage produces from its current state as a Stream
+    template<typename Gen>
+    Stream<typename Gen::value_type>
+    erase_stream(Gen gen) {
+        using value_type = typename Gen::value_type;
+
+        value_type head = gen.next();
+        return Stream<value_type>(head, [gen]() -> Stream<value_type> {
+            return erase_stream(gen);
+        });
+    }
+
+    // --------------------------
+    // LAZY STREAM
+    // --------------------------
+
+    // A Stream whose operations are composed at compile time instead of
+    // through a std::function per element. Every terminal operation runs the
+    // pipeline from its start, in a single loop the compiler can inline.
+    // Converting it to a Stream type erases the pipeline, which is then run
+    // an element at a time as the Stream's tails are asked for.
+    template<typename Gen>
+    class LazyStream {
+    private:
+        Gen Generator;
+    public:
+        using value_type = typename Gen::value_type;
+
+        LazyStream<Gen>(Gen gen) : Generator(gen) {};
+
+        // Return the recorded pipeline
+        const Gen&
+        generator() const {
+            return Generator;
+        };
+
+        // Return the first element of the Stream
+        value_type
+        head() const {
+            Gen gen = Generator;
+            return gen.next();
+        };
+
+        // Return a Collection with n elements taken from the Stream
+        Collection<value_type>
+        take(int n) const;
+
+        // Return a Collection with the elements at the start of the Stream
+        // that match the predicate function
+        template<typename Function>
+        Collection<value_type>
+        takeWhile(Function func) const {
+            std::vector<value_type> list;
+            Gen gen = Generator;
+            for (value_type x = gen.next(); func(x); x = gen.next())
+                list.push_back(x);
+            return Collection<value_type>(std::move(list));
+        };
+
+        // Record that the first n elements are skipped
+        LazyStream<StreamDrop<Gen>>
+        drop(int n) const {
+            return StreamDrop<Gen>{Generator, n};
+        };
+
+        // Return an iterator that runs the pipeline from its start, an
+        // element at a time, in constant memory
+        StreamStageIterator<Gen>
+        begin() const {
+            return StreamStageIterator<Gen>(Generator);
+        };
+
+        // Return the end of the Stream, which an iterator never reaches:
+        // loops over a LazyStream end with a break
+        StreamStageIterator<Gen>
+        end() const {
+            return StreamStageIterator<Gen>();
+        };
+
+        // Record the transformation of each element
+        template<typename Function>
+        LazyStream<StreamMap<Gen, Function>>
+        map(Function func) const {
+            return StreamMap<Gen, Function>{Generator, func};
+        };
+
+        // Record a predicate that elements must pass
+        template<typename Function>
+        LazyStream<StreamFilter<Gen, Function>>
+        filter(Function func) const {
+            return StreamFilter<Gen, Function>{Generator, func};
+        };
+
+        // Return the elements as a Stream
+        Stream<value_type>
+        stream() const {
+            return erase_stream(Generator);
+        };
+
+        operator Stream<value_type>() const {
+            return stream();
+        };
+    };
+
+    // Return a Collection with n elements taken from the Stream
+    template<typename Gen>
+    Collection<typename Gen::value_type>
+    LazyStream<Gen>::take(int n) const {
+        Collection<value_type> result(n);
+        value_type* list = result.Data;
+        Gen gen = Generator;
+        for (int i = 0; i < n; i++)
+            list[i] = gen.next();
+        return result;
+    }
+
+    //
+    // Non-member Functions
+    //
+
+    // Construct a LazyStream, starting at n, incrementing by step
+    template<typename T>
+    LazyStream<StreamFrom<T>>
+    lazy_from(T n, T step=1) {
+        return StreamFrom<T>{n, step};
+    }
+
+    // Construct a LazyStream whose values are the return values from repeated
+    // calls the generation function which takes no arguments
+    template<typename Function>
+    LazyStream<StreamGenerate<Function>>
+    lazy_generate(Function func) {
+        return StreamGenerate<Function>{func};
+    }
+
+    // Construct a LazyStream that consists of a repeated value
+    template<typename T>
+    LazyStream<StreamRepeat<T>>
+    lazy_repeat(T value) {
+        return StreamRepeat<T>{value};
+    }
+
+    // Given an initial value x and function f, return the LazyStream produced
+    // by x, f(x), f(f(x)), and so on
+    template<typename T, typename Function>
+    LazyStream<StreamIterate<T, Function>>
+    lazy_iterate(T value, Function func) {
+        return StreamIterate<T, Function>{value, func, false};
+    }
+
+    // Generalizes zip by zipping with the function given as the first argument
+    // instead of a tupling function
+    template<typename Function, typename ...Gen>
+    LazyStream<StreamZipWith<Function, Gen...>>
+    zipWith(Function func, LazyStream<Gen>... other_stream) {
+        return StreamZipWith<Function, Gen...>{func, std::make_tuple(other_stream.generator()...)};
+    }
+}
+
+#endif
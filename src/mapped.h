@@ -0,0 +1,162 @@
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cpp_collections {
+
+    // --------------------------
+    // MAPPED BUFFERS
+    // --------------------------
+
+    // A Collection can keep its elements in a memory mapped file instead of
+    // a buffer on the heap. The mapping is owned by the buffer's shared
+    // pointer, so it is unmapped once the last view of it is gone, and its
+    // deleter marks the buffer as mapped for the hints below, and as shared
+    // with a file that operations must not write into in place.
+
+    // How an operation is about to read a mapped buffer
+    enum class Access {
+        // front to back on one thread
+        Sequential,
+        // in chunks on the worker pool
+        Parallel
+    };
+
+    // Unmaps a file when its buffer is released
+    struct Unmap {
+        std::size_t Bytes;
+        // whether writes to the buffer reach the file
+        bool Shared;
+
+        void
+        operator()(void* address) const {
+            munmap(address, Bytes);
+        };
+    };
+
+    // Whether writing to a buffer would change a file it is mapped from
+    template<typename T>
+    bool
+    writes_through(const std::shared_ptr<T>& buffer) {
+        const Unmap* unmap = std::get_deleter<Unmap>(buffer);
+        return unmap && unmap->Shared;
+    }
+
+    // Throw the error that the last system call set
+    inline void
+    mapping_error(const std::string& what, const std::string& path) {
+        throw std::system_error(errno, std::system_category(), what + " " + path);
+    }
+
+    // Map 'bytes' bytes of an open file, closing it afterwards. A private
+    // mapping is copy on write, so the file is never changed through it.
+    template<typename T>
+    std::shared_ptr<T>
+    map_descriptor(int fd, std::size_t bytes, bool shared, const std::string& path) {
+        int flags = shared ? MAP_SHARED : MAP_PRIVATE;
+        void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED)
+            mapping_error("cannot map", path);
+        return std::shared_ptr<T>(static_cast<T*>(address), Unmap{bytes, shared});
+    }
+
+    // Map an existing file for reading, setting 'bytes' to its size. An
+    // empty file gives a null buffer.
+    inline std::shared_ptr<char>
+    map_bytes(const std::string& path, std::size_t& bytes) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            mapping_error("cannot open", path);
+
+        struct stat info;
+        if (fstat(fd, &info) < 0) {
+            close(fd);
+            mapping_error("cannot stat", path);
+        }
+
+        bytes = info.st_size;
+        if (bytes == 0) {
+            close(fd);
+            return nullptr;
+        }
+        return map_descriptor<char>(fd, bytes, false, path);
+    }
+
+    // Map an existing file of T for reading, setting 'length' to the number
+    // of elements in it. An empty file gives a null buffer.
+    template<typename T>
+    std::shared_ptr<T>
+    map_file(const std::string& path, int& length) {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Only trivially copyable types can be mapped from a file");
+
+        std::size_t bytes;
+        auto mapping = map_bytes(path, bytes);
+        if (bytes % sizeof(T) != 0 || bytes / sizeof(T) > INT_MAX)
+            throw std::length_error("cannot map " + path +
+                ": its size is not a whole number of elements that fits in an int");
+
+        length = bytes / sizeof(T);
+        T* begin = reinterpret_cast<T*>(mapping.get());
+        return std::shared_ptr<T>(std::move(mapping), begin);
+    }
+
+    // Create or truncate a file of 'length' zeroed elements of T and map it
+    // for writing, so that the elements are written to the file. No file
+    // space is mapped when 'length' is zero.
+    template<typename T>
+    std::shared_ptr<T>
+    create_file(const std::string& path, int length) {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Only trivially copyable types can be mapped to a file");
+
+        int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            mapping_error("cannot create", path);
+
+        std::size_t bytes = std::size_t(length) * sizeof(T);
+        if (ftruncate(fd, bytes) < 0) {
+            close(fd);
+            mapping_error("cannot resize", path);
+        }
+
+        if (length == 0) {
+            close(fd);
+            return nullptr;
+        }
+        return map_descriptor<T>(fd, bytes, true, path);
+    }
+
+    // Tell the kernel how the elements [begin, begin + length) of a buffer
+    // are about to be read, if the buffer is a mapped file: a sequential
+    // scan gets aggressive read-ahead, and chunks read in parallel are
+    // prefetched as a whole. Other buffers are left alone.
+    template<typename T>
+    void
+    advise(const std::shared_ptr<T>& buffer, const T* begin, int length, Access access) {
+        if (length == 0 || !std::get_deleter<Unmap>(buffer))
+            return;
+
+        static const std::size_t page = sysconf(_SC_PAGESIZE);
+        std::size_t first = reinterpret_cast<std::size_t>(begin) / page * page;
+        std::size_t end = reinterpret_cast<std::size_t>(begin + length);
+        madvise(reinterpret_cast<void*>(first), end - first,
+            access == Access::Sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+    }
+}
+
+#endif
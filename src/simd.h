@@ -0,0 +1,243 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CPP_COLLECTIONS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace cpp_collections {
+
+    // --------------------------
+    // CPU FEATURE DETECTION
+    // --------------------------
+
+    enum SimdLevel {
+        SIMD_SCALAR,
+        SIMD_SSE,       // SSE4.1
+        SIMD_AVX2,
+        SIMD_AVX512     // AVX-512F
+    };
+
+    // Return the widest instruction set the running CPU supports, detected
+    // once on first use
+    inline SimdLevel
+    simd_level() {
+#ifdef CPP_COLLECTIONS_X86_SIMD
+        static const SimdLevel level = []() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return SIMD_AVX512;
+            if (__builtin_cpu_supports("avx2"))
+                return SIMD_AVX2;
+            if (__builtin_cpu_supports("sse4.1"))
+                return SIMD_SSE;
+            return SIMD_SCALAR;
+        }();
+        return level;
+#else
+        return SIMD_SCALAR;
+#endif
+    }
+
+    // --------------------------
+    // SCALAR KERNELS
+    // --------------------------
+
+    struct SumOp {
+        template<typename T>
+        static T
+        apply(const T& a, const T& b) { return a + b; }
+    };
+
+    struct MinOp {
+        template<typename T>
+        static T
+        apply(const T& a, const T& b) { return b < a ? b : a; }
+    };
+
+    struct MaxOp {
+        template<typename T>
+        static T
+        apply(const T& a, const T& b) { return a < b ? b : a; }
+    };
+
+    // Fold n elements into seed with Op, one element at a time
+    template<typename Op, typename T>
+    T
+    scalar_reduce(const T* data, int n, T seed) {
+        for (int i = 0; i < n; i++)
+            seed = Op::apply(seed, data[i]);
+        return seed;
+    }
+
+    // --------------------------
+    // VECTOR KERNELS
+    // --------------------------
+
+#ifdef CPP_COLLECTIONS_X86_SIMD
+
+    // Stamp out a kernel that folds n elements into seed with a vector
+    // instruction, keeping four independent accumulators in flight and
+    // finishing the lanes and the leftover elements with the scalar Op
+    #define CPP_COLLECTIONS_SIMD_REDUCE(TARGET, NAME, T, VEC, LANES, PTR, LOAD, STORE, SET1, OP, SCALAR_OP) \
+        __attribute__((target(TARGET))) inline T                                      \
+        NAME(const T* data, int n, T seed) {                                           \
+            VEC a0 = SET1(seed), a1 = a0, a2 = a0, a3 = a0;                            \
+            int i = 0;                                                                 \
+            for (; i + 4 * LANES <= n; i += 4 * LANES) {                               \
+                a0 = OP(a0, LOAD((const PTR*)(data + i)));                             \
+                a1 = OP(a1, LOAD((const PTR*)(data + i + LANES)));                     \
+                a2 = OP(a2, LOAD((const PTR*)(data + i + 2 * LANES)));                 \
+                a3 = OP(a3, LOAD((const PTR*)(data + i + 3 * LANES)));                 \
+            }                                                                          \
+            for (; i + LANES <= n; i += LANES)                                         \
+                a0 = OP(a0, LOAD((const PTR*)(data + i)));                             \
+            a0 = OP(OP(a0, a1), OP(a2, a3));                                           \
+            T lanes[LANES];                                                            \
+            STORE((PTR*)lanes, a0);                                                    \
+            T val = scalar_reduce<SCALAR_OP>(lanes + 1, LANES - 1, lanes[0]);          \
+            return scalar_reduce<SCALAR_OP>(data + i, n - i, val);                     \
+        }
+
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_sum_i32, int32_t, __m128i, 4, __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_set1_epi32, _mm_add_epi32, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_sum_i64, int64_t, __m128i, 2, __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_set1_epi64x, _mm_add_epi64, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_sum_f32, float, __m128, 4, float, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_add_ps, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_sum_f64, double, __m128d, 2, double, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_add_pd, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_min_i32, int32_t, __m128i, 4, __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_set1_epi32, _mm_min_epi32, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_min_f32, float, __m128, 4, float, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_min_ps, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_min_f64, double, __m128d, 2, double, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_min_pd, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_max_i32, int32_t, __m128i, 4, __m128i, _mm_loadu_si128, _mm_storeu_si128, _mm_set1_epi32, _mm_max_epi32, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_max_f32, float, __m128, 4, float, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps, _mm_max_ps, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("sse4.1", sse_max_f64, double, __m128d, 2, double, _mm_loadu_pd, _mm_storeu_pd, _mm_set1_pd, _mm_max_pd, MaxOp)
+
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_sum_i32, int32_t, __m256i, 8, __m256i, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_set1_epi32, _mm256_add_epi32, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_sum_i64, int64_t, __m256i, 4, __m256i, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_set1_epi64x, _mm256_add_epi64, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_sum_f32, float, __m256, 8, float, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_add_ps, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_sum_f64, double, __m256d, 4, double, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_add_pd, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_min_i32, int32_t, __m256i, 8, __m256i, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_set1_epi32, _mm256_min_epi32, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_min_f32, float, __m256, 8, float, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_min_ps, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_min_f64, double, __m256d, 4, double, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_min_pd, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_max_i32, int32_t, __m256i, 8, __m256i, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_set1_epi32, _mm256_max_epi32, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_max_f32, float, __m256, 8, float, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps, _mm256_max_ps, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx2", avx2_max_f64, double, __m256d, 4, double, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_set1_pd, _mm256_max_pd, MaxOp)
+
+    // GCC's AVX-512 headers start min/max from an undefined register, which
+    // trips its own uninitialized-variable warnings
+    #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #endif
+
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_sum_i32, int32_t, __m512i, 16, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi32, _mm512_add_epi32, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_sum_i64, int64_t, __m512i, 8, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi64, _mm512_add_epi64, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_sum_f32, float, __m512, 16, float, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_add_ps, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_sum_f64, double, __m512d, 8, double, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_add_pd, SumOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_min_i32, int32_t, __m512i, 16, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi32, _mm512_min_epi32, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_min_i64, int64_t, __m512i, 8, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi64, _mm512_min_epi64, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_min_f32, float, __m512, 16, float, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_min_ps, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_min_f64, double, __m512d, 8, double, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_min_pd, MinOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_max_i32, int32_t, __m512i, 16, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi32, _mm512_max_epi32, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_max_i64, int64_t, __m512i, 8, void, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_set1_epi64, _mm512_max_epi64, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_max_f32, float, __m512, 16, float, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps, _mm512_max_ps, MaxOp)
+    CPP_COLLECTIONS_SIMD_REDUCE("avx512f", avx512_max_f64, double, __m512d, 8, double, _mm512_loadu_pd, _mm512_storeu_pd, _mm512_set1_pd, _mm512_max_pd, MaxOp)
+
+    #if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+    #endif
+
+    #undef CPP_COLLECTIONS_SIMD_REDUCE
+
+#endif
+
+    // --------------------------
+    // DISPATCH
+    // --------------------------
+
+    // Reductions over a contiguous block of elements. Types without vector
+    // kernels fall back to the scalar loop, which the compiler may still
+    // vectorize for the baseline instruction set. min and max seed the
+    // reduction with the first element, so they need at least one.
+    template<typename T>
+    struct simd_kernels {
+        static T
+        sum(const T* data, int n) { return scalar_reduce<SumOp>(data, n, T()); }
+
+        static T
+        min(const T* data, int n) { return scalar_reduce<MinOp>(data + 1, n - 1, data[0]); }
+
+        static T
+        max(const T* data, int n) { return scalar_reduce<MaxOp>(data + 1, n - 1, data[0]); }
+    };
+
+#ifdef CPP_COLLECTIONS_X86_SIMD
+
+    // Define OP to call the kernel for the widest instruction set the CPU
+    // supports, out of the AVX512, AVX2 and SSE kernels given
+    #define CPP_COLLECTIONS_SIMD_DISPATCH(T, OP, AVX512, AVX2, SSE, SEED)        \
+        static T                                                                \
+        OP(const T* data, int n) {                                              \
+            switch (simd_level()) {                                             \
+            case SIMD_AVX512: return AVX512(data, n, T(SEED));                  \
+            case SIMD_AVX2:   return AVX2(data, n, T(SEED));                    \
+            case SIMD_SSE:    return SSE(data, n, T(SEED));                     \
+            default:          return simd_kernels_scalar_##OP(data, n, T(SEED));\
+            }                                                                   \
+        }
+
+    template<typename T>
+    inline T
+    simd_kernels_scalar_sum(const T* data, int n, T seed) {
+        return scalar_reduce<SumOp>(data, n, seed);
+    }
+
+    template<typename T>
+    inline T
+    simd_kernels_scalar_min(const T* data, int n, T seed) {
+        return scalar_reduce<MinOp>(data, n, seed);
+    }
+
+    template<typename T>
+    inline T
+    simd_kernels_scalar_max(const T* data, int n, T seed) {
+        return scalar_reduce<MaxOp>(data, n, seed);
+    }
+
+    template<>
+    struct simd_kernels<int32_t> {
+        CPP_COLLECTIONS_SIMD_DISPATCH(int32_t, sum, avx512_sum_i32, avx2_sum_i32, sse_sum_i32, 0)
+        CPP_COLLECTIONS_SIMD_DISPATCH(int32_t, min, avx512_min_i32, avx2_min_i32, sse_min_i32, data[0])
+        CPP_COLLECTIONS_SIMD_DISPATCH(int32_t, max, avx512_max_i32, avx2_max_i32, sse_max_i32, data[0])
+    };
+
+    // there are no 64-bit integer min/max instructions below AVX-512
+    template<>
+    struct simd_kernels<int64_t> {
+        CPP_COLLECTIONS_SIMD_DISPATCH(int64_t, sum, avx512_sum_i64, avx2_sum_i64, sse_sum_i64, 0)
+        CPP_COLLECTIONS_SIMD_DISPATCH(int64_t, min, avx512_min_i64, simd_kernels_scalar_min, simd_kernels_scalar_min, data[0])
+        CPP_COLLECTIONS_SIMD_DISPATCH(int64_t, max, avx512_max_i64, simd_kernels_scalar_max, simd_kernels_scalar_max, data[0])
+    };
+
+    template<>
+    struct simd_kernels<float> {
+        CPP_COLLECTIONS_SIMD_DISPATCH(float, sum, avx512_sum_f32, avx2_sum_f32, sse_sum_f32, 0.0f)
+        CPP_COLLECTIONS_SIMD_DISPATCH(float, min, avx512_min_f32, avx2_min_f32, sse_min_f32, data[0])
+        CPP_COLLECTIONS_SIMD_DISPATCH(float, max, avx512_max_f32, avx2_max_f32, sse_max_f32, data[0])
+    };
+
+    template<>
+    struct simd_kernels<double> {
+        CPP_COLLECTIONS_SIMD_DISPATCH(double, sum, avx512_sum_f64, avx2_sum_f64, sse_sum_f64, 0.0)
+        CPP_COLLECTIONS_SIMD_DISPATCH(double, min, avx512_min_f64, avx2_min_f64, sse_min_f64, data[0])
+        CPP_COLLECTIONS_SIMD_DISPATCH(double, max, avx512_max_f64, avx2_max_f64, sse_max_f64, data[0])
+    };
+
+    #undef CPP_COLLECTIONS_SIMD_DISPATCH
+
+#endif
+}
+
+#endif
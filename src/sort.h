@@ -0,0 +1,266 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace cpp_collections {
+
+    // --------------------------
+    // SORTING
+    // --------------------------
+
+    // Collections sort with an LSD radix sort when the sort key is an integer
+    // or floating point type, and with a merge sort of chunks sorted on the
+    // shared worker pool otherwise. Both are run in parallel chunks, and the
+    // radix sort is stable.
+
+    // Below this many elements a plain comparison sort is faster than either
+    const int sort_threshold = 2048;
+
+    // Whether keys of type K are radix sorted, and how they are turned into
+    // unsigned integers of the same order
+    template<typename K, typename Enable = void>
+    struct radix_key : std::false_type {};
+
+    template<typename K>
+    struct radix_key<K, typename std::enable_if<std::is_integral<K>::value &&
+        !std::is_same<K, bool>::value && sizeof(K) <= 8>::type>
+        : std::true_type {
+        using bits = typename std::conditional<(sizeof(K) <= 4), uint32_t, uint64_t>::type;
+
+        // flipping the sign bit orders negative numbers before the rest
+        static bits
+        encode(K key) {
+            bits value = bits(typename std::make_unsigned<K>::type(key));
+            return std::is_signed<K>::value ? value ^ (bits(1) << (8 * sizeof(K) - 1)) : value;
+        };
+
+        static K
+        decode(bits value) {
+            if (std::is_signed<K>::value)
+                value ^= bits(1) << (8 * sizeof(K) - 1);
+            return K(typename std::make_unsigned<K>::type(value));
+        };
+    };
+
+    template<typename K>
+    struct radix_key<K, typename std::enable_if<std::is_floating_point<K>::value &&
+        (sizeof(K) == 4 || sizeof(K) == 8)>::type> : std::true_type {
+        using bits = typename std::conditional<(sizeof(K) == 4), uint32_t, uint64_t>::type;
+
+        // negative numbers have their bits inverted so that larger
+        // magnitudes come first, and positive ones get their sign bit set
+        static bits
+        encode(K key) {
+            bits value;
+            std::memcpy(&value, &key, sizeof(K));
+            bits sign = bits(1) << (8 * sizeof(K) - 1);
+            return (value & sign) ? ~value : value | sign;
+        };
+
+        static K
+        decode(bits value) {
+            bits sign = bits(1) << (8 * sizeof(K) - 1);
+            value = (value & sign) ? value & ~sign : ~value;
+            K key;
+            std::memcpy(&key, &value, sizeof(K));
+            return key;
+        };
+    };
+
+    // Sort 'n' unsigned keys with an LSD radix sort on bytes, moving the
+    // values along with them when 'values' isn't null. Each pass counts the
+    // bytes of every chunk on the shared worker pool and then scatters the
+    // chunks in parallel, and passes over a byte that all keys share are
+    // skipped.
+    template<typename Bits, typename Value>
+    void
+    radix_sort(Bits* keys, Value* values, int n, int threads) {
+        int chunks = parallel_chunks(n, threads);
+        std::vector<Bits> key_scratch(n);
+        std::vector<Value> value_scratch(values ? n : 0);
+        Bits* key_from = keys;
+        Bits* key_to = key_scratch.data();
+        Value* value_from = values;
+        Value* value_to = value_scratch.data();
+        std::vector<std::array<int, 256>> counts(chunks);
+
+        for (int shift = 0; shift < 8 * int(sizeof(Bits)); shift += 8) {
+            thread_pool().parallel_for(0, n, chunks, threads,
+                [&](int chunk, int begin, int end) {
+                    auto& count = counts[chunk];
+                    count.fill(0);
+                    for (int i = begin; i < end; i++)
+                        count[(key_from[i] >> shift) & 0xff]++;
+                });
+
+            // turn the counts into where each chunk writes each byte, in the
+            // order of the bytes and then of the chunks to keep the sort stable
+            int offset = 0;
+            bool shared = false;
+            for (int digit = 0; digit < 256; digit++) {
+                int total = 0;
+                for (int chunk = 0; chunk < chunks; chunk++) {
+                    int count = counts[chunk][digit];
+                    counts[chunk][digit] = offset + total;
+                    total += count;
+                }
+                shared = shared || total == n;
+                offset += total;
+            }
+            if (shared)
+                continue;
+
+            thread_pool().parallel_for(0, n, chunks, threads,
+                [&](int chunk, int begin, int end) {
+                    auto& position = counts[chunk];
+                    for (int i = begin; i < end; i++) {
+                        int to = position[(key_from[i] >> shift) & 0xff]++;
+                        key_to[to] = key_from[i];
+                        if (values)
+                            value_to[to] = std::move(value_from[i]);
+                    }
+                });
+            std::swap(key_from, key_to);
+            std::swap(value_from, value_to);
+        }
+
+        // an odd number of passes leaves the result in the scratch space
+        if (key_from != keys) {
+            std::copy(key_from, key_from + n, keys);
+            if (values)
+                std::move(value_from, value_from + n, values);
+        }
+    }
+
+    // Sort 'n' elements with a comparison function by sorting chunks on the
+    // shared worker pool and then merging pairs of sorted runs in parallel
+    // until one is left. With 'stable' equal elements keep their order.
+    template<typename T, typename Compare>
+    void
+    merge_sort(T* data, int n, Compare less, bool stable, int threads) {
+        if (n < sort_threshold) {
+            if (stable)
+                std::stable_sort(data, data + n, less);
+            else
+                std::sort(data, data + n, less);
+            return;
+        }
+
+        int chunks = parallel_chunks(n, threads);
+        // the sorted runs are [bounds[i], bounds[i + 1])
+        std::vector<int> bounds(1, 0);
+        thread_pool().parallel_for(0, n, chunks, threads,
+            [&](int, int begin, int end) {
+                if (stable)
+                    std::stable_sort(data + begin, data + end, less);
+                else
+                    std::sort(data + begin, data + end, less);
+            });
+        for (int i = 0; i < chunks; i++)
+            bounds.push_back(n / chunks * (i + 1) + std::min(i + 1, n % chunks));
+
+        // not a std::vector, which packs bools into bits
+        std::unique_ptr<T[]> scratch(new T[n]);
+        T* from = data;
+        T* to = scratch.get();
+        while (bounds.size() > 2) {
+            int runs = bounds.size() - 1;
+            int pairs = (runs + 1) / 2;
+            thread_pool().parallel_for(0, pairs, pairs, threads,
+                [&](int, int begin, int end) {
+                    for (int pair = begin; pair < end; pair++) {
+                        int low = bounds[2 * pair];
+                        int middle = bounds[std::min(2 * pair + 1, runs)];
+                        int high = bounds[std::min(2 * pair + 2, runs)];
+                        std::merge(std::make_move_iterator(from + low),
+                            std::make_move_iterator(from + middle),
+                            std::make_move_iterator(from + middle),
+                            std::make_move_iterator(from + high),
+                            to + low, less);
+                    }
+                });
+
+            std::vector<int> merged;
+            for (int i = 0; i < int(bounds.size()); i += 2)
+                merged.push_back(bounds[i]);
+            if (merged.back() != n)
+                merged.push_back(n);
+            bounds.swap(merged);
+            std::swap(from, to);
+        }
+
+        if (from != data)
+            std::move(from, from + n, data);
+    }
+
+    // Sort 'n' elements in ascending order
+    template<typename T>
+    void
+    sort_elements(T* data, int n, int threads, std::true_type) {
+        if (n < sort_threshold) {
+            std::sort(data, data + n);
+            return;
+        }
+        using bits = typename radix_key<T>::bits;
+        std::vector<bits> keys(n);
+        for (int i = 0; i < n; i++)
+            keys[i] = radix_key<T>::encode(data[i]);
+        radix_sort(keys.data(), static_cast<char*>(nullptr), n, threads);
+        for (int i = 0; i < n; i++)
+            data[i] = radix_key<T>::decode(keys[i]);
+    }
+
+    template<typename T>
+    void
+    sort_elements(T* data, int n, int threads, std::false_type) {
+        merge_sort(data, n, std::less<T>(), false, threads);
+    }
+
+    // Sort 'n' elements by the keys a function returns for them, radix
+    // sorting the keys together with the positions of their elements
+    template<typename T, typename Function>
+    void
+    sort_by_key(T* data, int n, Function key, bool, int threads, std::true_type) {
+        using key_type = typename std::decay<typename std::result_of<Function(T)>::type>::type;
+        auto less = [&](const T& a, const T& b) { return key(a) < key(b); };
+        if (n < sort_threshold) {
+            std::stable_sort(data, data + n, less);
+            return;
+        }
+
+        using bits = typename radix_key<key_type>::bits;
+        std::vector<bits> keys(n);
+        std::vector<int> positions(n);
+        for (int i = 0; i < n; i++) {
+            keys[i] = radix_key<key_type>::encode(key(data[i]));
+            positions[i] = i;
+        }
+        radix_sort(keys.data(), positions.data(), n, threads);
+
+        std::unique_ptr<T[]> sorted(new T[n]);
+        for (int i = 0; i < n; i++)
+            sorted[i] = std::move(data[positions[i]]);
+        std::move(sorted.get(), sorted.get() + n, data);
+    }
+
+    template<typename T, typename Function>
+    void
+    sort_by_key(T* data, int n, Function key, bool stable, int threads, std::false_type) {
+        merge_sort(data, n, [&](const T& a, const T& b) { return key(a) < key(b); },
+            stable, threads);
+    }
+}
+
+#endif
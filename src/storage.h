@@ -0,0 +1,424 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mapped.h"
+#include "utility.h"
+
+namespace cpp_collections {
+
+    // --------------------------
+    // STORED COLLECTIONS
+    // --------------------------
+
+    // Collections are saved in a columnar binary format: a FileHeader, one
+    // ColumnHeader per column, then for each column its elements, the
+    // smallest and largest element of every block (for arithmetic types) and
+    // a checksum of every block. Each section starts on a 64 byte boundary,
+    // so a mapped file can be used in place. A Collection has one column,
+    // and a Collection of tuples or a ZippedView has one per tuple element.
+    // Files are written in the byte order of the machine that saves them.
+
+    // The number of elements covered by each bound and checksum
+    const int stored_block = 1 << 16;
+
+    struct FileHeader {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t Columns;
+        uint64_t Count;
+        uint32_t Block;
+        char Reserved[36];
+    };
+
+    struct ColumnHeader {
+        // the type_tag and size of the elements
+        uint32_t Tag;
+        uint32_t Size;
+        // whether the column has bounds
+        uint32_t Bounded;
+        uint32_t Reserved;
+        // where the elements, bounds and checksums start in the file
+        uint64_t Elements;
+        uint64_t Bounds;
+        uint64_t Checksums;
+        char Padding[24];
+    };
+
+    static_assert(sizeof(FileHeader) == 64 && sizeof(ColumnHeader) == 64,
+        "Stored headers must keep their layout");
+
+    // Identify the type of a column, so that it is read back as the same
+    // type: arithmetic types by their kind and size, and other trivially
+    // copyable types by their size alone
+    template<typename T>
+    struct type_tag : std::integral_constant<uint32_t,
+        std::is_floating_point<T>::value ? 0x300 + sizeof(T) :
+        std::is_integral<T>::value ? (std::is_signed<T>::value ? 0x100 : 0x200) + sizeof(T) :
+        0> {};
+
+    // Whether a type is a std::tuple, which is stored as one column per
+    // element
+    template<typename T>
+    struct is_tuple : std::false_type {};
+
+    template<typename ...U>
+    struct is_tuple<std::tuple<U...>> : std::true_type {};
+
+    // Return a 64 bit checksum of some bytes
+    inline uint64_t
+    checksum(const char* bytes, std::size_t n) {
+        uint64_t hash = 0x9e3779b97f4a7c15ULL ^ n;
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 32;
+        }
+        for (; i < n; i++)
+            hash = (hash ^ (unsigned char) bytes[i]) * 0x100000001b3ULL;
+        return hash;
+    }
+
+    // Round an offset up to the start of the next section
+    inline uint64_t
+    section(uint64_t offset) {
+        return (offset + 63) / 64 * 64;
+    }
+
+    // Describe a column of T
+    template<typename T>
+    ColumnHeader
+    describe() {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "Only trivially copyable types can be stored");
+
+        ColumnHeader column = {};
+        column.Tag = type_tag<T>::value;
+        column.Size = sizeof(T);
+        column.Bounded = std::is_arithmetic<T>::value;
+        return column;
+    }
+
+    // Writes a stored file one column at a time, each with a single write of
+    // its elements
+    class StorageWriter {
+    private:
+        std::string Path;
+        std::unique_ptr<FILE, int(*)(FILE*)> File;
+        std::vector<ColumnHeader> Layout;
+        uint64_t Count;
+        int Next;
+
+        // Write 'bytes' bytes at 'offset', padding the file up to it
+        void
+        write(const void* data, std::size_t bytes, uint64_t offset);
+
+        // Write the smallest and largest element of every block of a column
+        template<typename T>
+        void
+        bounds(const T* data, const ColumnHeader& column, std::true_type);
+
+        template<typename T>
+        void
+        bounds(const T*, const ColumnHeader&, std::false_type) {};
+
+    public:
+
+        // Create the file at 'path' for 'count' elements in the described
+        // columns, and write its headers
+        StorageWriter(const std::string& path, uint64_t count, std::vector<ColumnHeader> columns);
+
+        // Write the elements of the next column
+        template<typename T>
+        void
+        column(const T* data);
+
+        // Flush the file, reporting any error that writing it met
+        void
+        close();
+    };
+
+    // Create the file at 'path' for 'count' elements in the described
+    // columns, and write its headers
+    inline
+    StorageWriter::StorageWriter(const std::string& path, uint64_t count, std::vector<ColumnHeader> columns)
+        : Path(path), File(fopen(path.c_str(), "wb"), fclose),
+          Layout(std::move(columns)), Count(count), Next(0) {
+        if (!File)
+            mapping_error("cannot create", path);
+
+        uint64_t blocks = (count + stored_block - 1) / stored_block;
+        uint64_t offset = section(sizeof(FileHeader) + Layout.size() * sizeof(ColumnHeader));
+        for (auto& column : Layout) {
+            column.Elements = offset;
+            offset = section(offset + count * column.Size);
+            column.Bounds = column.Bounded ? offset : 0;
+            if (column.Bounded)
+                offset = section(offset + blocks * 2 * column.Size);
+            column.Checksums = offset;
+            offset = section(offset + blocks * sizeof(uint64_t));
+        }
+
+        FileHeader header = {};
+        std::memcpy(header.Magic, "CPPCOLS", 8);
+        header.Version = 1;
+        header.Columns = Layout.size();
+        header.Count = count;
+        header.Block = stored_block;
+        write(&header, sizeof(header), 0);
+        write(Layout.data(), Layout.size() * sizeof(ColumnHeader), sizeof(header));
+    }
+
+    // Write 'bytes' bytes at 'offset', padding the file up to it
+    inline void
+    StorageWriter::write(const void* data, std::size_t bytes, uint64_t offset) {
+        static const char zeros[64] = {};
+        long position = ftell(File.get());
+        if (position < 0 || uint64_t(position) > offset ||
+            fwrite(zeros, 1, offset - position, File.get()) != offset - position ||
+            (bytes && fwrite(data, 1, bytes, File.get()) != bytes))
+            mapping_error("cannot write", Path);
+    }
+
+    // Write the smallest and largest element of every block of a column
+    template<typename T>
+    void
+    StorageWriter::bounds(const T* data, const ColumnHeader& column, std::true_type) {
+        uint64_t blocks = (Count + stored_block - 1) / stored_block;
+        std::unique_ptr<T[]> list(new T[2 * blocks]);
+        for (uint64_t i = 0; i < blocks; i++) {
+            auto block = std::minmax_element(data + i * stored_block,
+                data + std::min<uint64_t>(Count, (i + 1) * stored_block));
+            list[2 * i] = *block.first;
+            list[2 * i + 1] = *block.second;
+        }
+        write(list.get(), 2 * blocks * sizeof(T), column.Bounds);
+    }
+
+    // Write the elements of the next column
+    template<typename T>
+    void
+    StorageWriter::column(const T* data) {
+        const ColumnHeader& column = Layout[Next++];
+        if (column.Tag != type_tag<T>::value || column.Size != sizeof(T))
+            throw std::logic_error("column written as a different type than described");
+
+        write(data, Count * sizeof(T), column.Elements);
+        bounds(data, column, std::integral_constant<bool, std::is_arithmetic<T>::value>());
+
+        std::vector<uint64_t> checksums;
+        const char* bytes = reinterpret_cast<const char*>(data);
+        for (uint64_t i = 0; i < Count; i += stored_block) {
+            uint64_t length = std::min<uint64_t>(Count - i, stored_block);
+            checksums.push_back(checksum(bytes + i * sizeof(T), length * sizeof(T)));
+        }
+        write(checksums.data(), checksums.size() * sizeof(uint64_t), column.Checksums);
+    }
+
+    // Flush the file, reporting any error that writing it met
+    inline void
+    StorageWriter::close() {
+        if (Next != int(Layout.size()))
+            throw std::logic_error("not every column of " + Path + " was written");
+        // pad the last section so that every section is whole
+        static const char zero = 0;
+        long position = ftell(File.get());
+        write(&zero, 0, section(position));
+        if (fclose(File.release()) != 0)
+            mapping_error("cannot write", Path);
+    }
+
+    // A stored file mapped into memory, whose columns are read in place
+    class StoredFile {
+    private:
+        std::string Path;
+        std::shared_ptr<char> Bytes;
+        std::size_t Size;
+        FileHeader Header;
+
+        // Throw an error describing why the file can't be read
+        void
+        invalid(const std::string& why) const {
+            throw std::runtime_error("cannot load " + Path + ": " + why);
+        };
+
+        // Return the header of column 'index', checking that it holds T
+        template<typename T>
+        ColumnHeader
+        column_header(int index) const;
+
+    public:
+
+        // Map the file at 'path' and check its header
+        StoredFile(const std::string& path);
+
+        // Return the number of elements in each column
+        int
+        size() const {
+            return Header.Count;
+        };
+
+        // Return the number of columns
+        int
+        columns() const {
+            return Header.Columns;
+        };
+
+        // Return column 'index' as elements of T, which share the mapping,
+        // optionally checking it against its checksums first
+        template<typename T>
+        std::shared_ptr<T>
+        column(int index, bool verify) const;
+
+        // Return the smallest and the largest element of every block of
+        // column 'index', so that blocks can be skipped without reading them
+        template<typename T>
+        std::vector<std::pair<T, T>>
+        bounds(int index) const;
+    };
+
+    // Map the file at 'path' and check its header
+    inline
+    StoredFile::StoredFile(const std::string& path) : Path(path) {
+        Bytes = map_bytes(path, Size);
+        if (Size < sizeof(FileHeader))
+            invalid("it is too small to be a stored Collection");
+
+        std::memcpy(&Header, Bytes.get(), sizeof(Header));
+        if (std::memcmp(Header.Magic, "CPPCOLS", 8) != 0)
+            invalid("it is not a stored Collection");
+        if (Header.Version != 1)
+            invalid("it has an unknown version");
+        if (Header.Count > INT_MAX || Header.Block != stored_block)
+            invalid("its elements don't fit in a Collection");
+        if (Size < sizeof(FileHeader) + uint64_t(Header.Columns) * sizeof(ColumnHeader))
+            invalid("it is truncated");
+    }
+
+    // Return the header of column 'index', checking that it holds T
+    template<typename T>
+    ColumnHeader
+    StoredFile::column_header(int index) const {
+        if (index >= int(Header.Columns))
+            invalid("it has too few columns");
+
+        ColumnHeader column;
+        std::memcpy(&column, Bytes.get() + sizeof(FileHeader) + index * sizeof(ColumnHeader),
+            sizeof(column));
+        if (column.Tag != type_tag<T>::value || column.Size != sizeof(T))
+            invalid("column " + std::to_string(index) + " holds a different type");
+
+        uint64_t blocks = (Header.Count + stored_block - 1) / stored_block;
+        if (column.Elements % 64 != 0 || column.Checksums % 64 != 0 ||
+            column.Elements + Header.Count * sizeof(T) > Size ||
+            column.Checksums + blocks * sizeof(uint64_t) > Size ||
+            (column.Bounded && column.Bounds + blocks * 2 * sizeof(T) > Size))
+            invalid("it is truncated");
+        return column;
+    }
+
+    // Return column 'index' as elements of T, which share the mapping,
+    // optionally checking it against its checksums first
+    template<typename T>
+    std::shared_ptr<T>
+    StoredFile::column(int index, bool verify) const {
+        ColumnHeader column = column_header<T>(index);
+        const char* elements = Bytes.get() + column.Elements;
+
+        if (verify) {
+            const uint64_t* checksums = reinterpret_cast<const uint64_t*>(Bytes.get() + column.Checksums);
+            for (uint64_t i = 0, block = 0; i < Header.Count; i += stored_block, block++) {
+                uint64_t length = std::min<uint64_t>(Header.Count - i, stored_block);
+                if (checksum(elements + i * sizeof(T), length * sizeof(T)) != checksums[block])
+                    invalid("block " + std::to_string(block) + " of column " +
+                        std::to_string(index) + " is corrupt");
+            }
+        }
+        return std::shared_ptr<T>(Bytes, reinterpret_cast<T*>(Bytes.get() + column.Elements));
+    }
+
+    // Return the smallest and the largest element of every block of column
+    // 'index', so that blocks can be skipped without reading them
+    template<typename T>
+    std::vector<std::pair<T, T>>
+    StoredFile::bounds(int index) const {
+        ColumnHeader column = column_header<T>(index);
+        if (!column.Bounded)
+            invalid("column " + std::to_string(index) + " has no bounds");
+
+        uint64_t blocks = (Header.Count + stored_block - 1) / stored_block;
+        const T* list = reinterpret_cast<const T*>(Bytes.get() + column.Bounds);
+        std::vector<std::pair<T, T>> result;
+        for (uint64_t i = 0; i < blocks; i++)
+            result.push_back(std::make_pair(list[2 * i], list[2 * i + 1]));
+        return result;
+    }
+
+    // Save 'length' elements of T to a file with a single column
+    template<typename T>
+    void
+    store(const std::string& path, const T* data, int length) {
+        StorageWriter writer(path, length, {describe<T>()});
+        writer.column(data);
+        writer.close();
+    }
+
+    // Copy element I of every tuple into a column and write it
+    template<std::size_t I, typename ...U>
+    void
+    store_column(StorageWriter& writer, const std::tuple<U...>* rows, int length) {
+        using column_type = typename std::tuple_element<I, std::tuple<U...>>::type;
+        // not a std::vector, which packs bools into bits
+        std::unique_ptr<column_type[]> column(new column_type[length]);
+        for (int i = 0; i < length; i++)
+            column[i] = std::get<I>(rows[i]);
+        writer.column(column.get());
+    }
+
+    template<typename ...U, std::size_t ...I>
+    void
+    store(const std::string& path, const std::tuple<U...>* rows, int length, index_list<I...>) {
+        StorageWriter writer(path, length, {describe<U>()...});
+        int expand[] = {0, (store_column<I>(writer, rows, length), 0)...};
+        (void) expand;
+        writer.close();
+    }
+
+    // Save 'length' tuples to a file with one column per tuple element
+    template<typename ...U>
+    void
+    store(const std::string& path, const std::tuple<U...>* rows, int length) {
+        store(path, rows, length, typename make_index_list<sizeof...(U)>::type());
+    }
+
+    template<typename ...U, std::size_t ...I>
+    void
+    restore(const StoredFile& file, std::tuple<U...>* rows, int length, bool verify, index_list<I...>) {
+        auto columns = std::make_tuple(file.column<U>(I, verify)...);
+        for (int i = 0; i < length; i++)
+            rows[i] = std::tuple<U...>(std::get<I>(columns).get()[i]...);
+    }
+
+    // Read 'length' tuples from the columns of a stored file
+    template<typename ...U>
+    void
+    restore(const StoredFile& file, std::tuple<U...>* rows, int length, bool verify) {
+        restore(file, rows, length, verify, typename make_index_list<sizeof...(U)>::type());
+    }
+}
+
+#endif
@@ -3,11 +3,13 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <pthread.h>
 #include <stdio.h>
 #include <tuple>
@@ -25,23 +27,53 @@ namespace cpp_collections {
     template<typename T>
     class Stream {
     private:
+        // The rest of a Stream after its head, which runs the generator the
+        // first time it is needed and then keeps the result for every copy
+        // of the Stream
+        struct Thunk;
+
         T Head;
-        std::shared_ptr<Stream<T>> Tail;
-        std::function<Stream<T>()> Gen;
+        std::shared_ptr<Thunk> Rest;
+
+        // Stream constructor from an already computed rest
+        Stream<T>(T head, std::shared_ptr<Thunk> rest) {
+            Head = head;
+            Rest = rest;
+        }
+
+        // Compute the tail of a Stream if it hasn't been yet, and return it
+        static Thunk&
+        forced(const std::shared_ptr<Thunk>& rest);
+
+        // Return the Stream from the first element that matches the predicate
+        // function onwards, filtering its tail lazily. Skipped elements are
+        // walked in a loop, and released as it goes unless they are shared.
+        static Stream<T>
+        filtered(Stream<T> stream, std::function<bool(T)> func);
+
+        // Return the Stream without its first n elements, walking them in a
+        // loop and releasing them as it goes unless they are shared
+        static Stream<T>
+        dropped(Stream<T> stream, int n);
+
     public:
 
+        // An input iterator over the elements of a Stream
+        class iterator;
+
         // Default Stream constructor
         Stream<T>(T head, std::function<Stream<T>()> gen) {
             Head = head;
-            Tail = nullptr;
-            Gen  = gen;
+            Rest = std::make_shared<Thunk>();
+            Rest->Gen = gen;
         }
 
         // Tail-only Stream constructor
         Stream<T>(T head, Stream<T> tail) {
             Head = head;
-            Tail = std::make_shared<Stream<T>>(tail);
-            Gen  = nullptr;
+            Rest = std::make_shared<Thunk>();
+            Rest->Head = tail.Head;
+            Rest->Next = tail.Rest;
         }
 
         // Return the first element of the Stream
@@ -56,10 +88,43 @@ namespace cpp_collections {
         Collection<T>
         take(int n);
 
+        // Return a Collection with the elements at the start of the Stream
+        // that match the predicate function
+        template<typename Function>
+        Collection<T>
+        takeWhile(Function func) const;
+
+        // Return the Stream without its first n elements
+        Stream<T>
+        drop(int n) const &;
+
+        // Return the Stream without its first n elements, without keeping the
+        // dropped elements in memory
+        Stream<T>
+        drop(int n) &&;
+
+        // Return an iterator to the first element. An iterator keeps only the
+        // Stream from its element onwards, so one taken from a temporary
+        // Stream runs in constant memory, while a range-based for loop keeps
+        // the Stream it loops over and so every element it computes.
+        iterator
+        begin() const;
+
+        // Return the end of the Stream, which an iterator over an unbounded
+        // Stream never reaches: loops over one end with a break
+        iterator
+        end() const;
+
         // Return a substream of elements of the Stream that match the
         // predicate function
         Stream<T>
-        filter(std::function<bool(T)> func) const;
+        filter(std::function<bool(T)> func) const &;
+
+        // Return a substream of elements of the Stream that match the
+        // predicate function, without keeping the elements skipped to find
+        // the first match in memory
+        Stream<T>
+        filter(std::function<bool(T)> func) &&;
 
         // Return the Stream that results from the transformation of each
         // element in the original Stream
@@ -69,6 +134,80 @@ namespace cpp_collections {
 
     };
 
+    template<typename T>
+    struct Stream<T>::Thunk {
+        // null once the tail has been computed
+        std::function<Stream<T>()> Gen;
+        std::once_flag Forced;
+        // the head and rest of the tail
+        T Head;
+        std::shared_ptr<Thunk> Next;
+
+        // Release a long chain of computed tails one at a time, instead of
+        // recursively through their destructors
+        ~Thunk() {
+            std::shared_ptr<Thunk> next = std::move(Next);
+            while (next && next.use_count() == 1)
+                next = std::move(next->Next);
+        };
+    };
+
+    template<typename T>
+    class Stream<T>::iterator {
+    private:
+        T Head;
+        // null at the end
+        std::shared_ptr<Thunk> Rest;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator() {};
+
+        iterator(T head, std::shared_ptr<Thunk> rest) : Head(head), Rest(rest) {};
+
+        const T&
+        operator*() const {
+            return Head;
+        };
+
+        const T*
+        operator->() const {
+            return &Head;
+        };
+
+        // Move on to the next element, computing it if it hasn't been yet
+        iterator&
+        operator++() {
+            Thunk& rest = forced(Rest);
+            std::shared_ptr<Thunk> next = rest.Next;
+            Head = rest.Head;
+            Rest = std::move(next);
+            return *this;
+        };
+
+        iterator
+        operator++(int) {
+            iterator previous = *this;
+            ++*this;
+            return previous;
+        };
+
+        bool
+        operator==(const iterator& other) const {
+            return Rest == other.Rest;
+        };
+
+        bool
+        operator!=(const iterator& other) const {
+            return Rest != other.Rest;
+        };
+    };
+
     // Return the first element of the Stream
     template<typename T>
     T
@@ -76,16 +215,33 @@ namespace cpp_collections {
         return Head;
     }
 
-    // Create the tail Stream by removing the head
+    // Create the tail Stream by removing the head. The generator runs only
+    // the first time, even when copies of the Stream ask from several threads.
     template<typename T>
     Stream<T>
     Stream<T>::tail() const {
-        if (Tail)
-            return *Tail;
-        return Gen();
+        Thunk& rest = forced(Rest);
+        return Stream<T>(rest.Head, rest.Next);
+    }
+
+    // Compute the tail of a Stream if it hasn't been yet, and return it
+    template<typename T>
+    typename Stream<T>::Thunk&
+    Stream<T>::forced(const std::shared_ptr<Thunk>& rest) {
+        Thunk& thunk = *rest;
+        std::call_once(thunk.Forced, [&thunk]() {
+            if (thunk.Gen) {
+                Stream<T> next = thunk.Gen();
+                thunk.Head = std::move(next.Head);
+                thunk.Next = std::move(next.Rest);
+                thunk.Gen = nullptr;
+            }
+        });
+        return thunk;
     }
 
-    // Return a Collection with n elements taken from the Stream
+    // Return a Collection with n elements taken from the Stream. Tails are
+    // computed up to the last element taken, not past it.
     template<typename T>
     Collection<T>
     Stream<T>::take(int n) {
@@ -93,9 +249,57 @@ namespace cpp_collections {
         Stream<T> temp = *this;
         for (int i = 0; i < n; i++) { 
             list[i] = temp.head();
-            temp = temp.tail();
+            if (i + 1 < n)
+                temp = temp.tail();
         }
-        return Collection<T>(list);
+        return Collection<T>(std::move(list));
+    }
+
+    // Return a Collection with the elements at the start of the Stream that
+    // match the predicate function
+    template<typename T>
+    template<typename Function>
+    Collection<T>
+    Stream<T>::takeWhile(Function func) const {
+        std::vector<T> list;
+        for (iterator it = begin(); func(*it); ++it)
+            list.push_back(*it);
+        return Collection<T>(std::move(list));
+    }
+
+    // Return the Stream without its first n elements
+    template<typename T>
+    Stream<T>
+    Stream<T>::dropped(Stream<T> stream, int n) {
+        for (int i = 0; i < n; i++)
+            stream = stream.tail();
+        return stream;
+    }
+
+    template<typename T>
+    Stream<T>
+    Stream<T>::drop(int n) const & {
+        return dropped(*this, n);
+    }
+
+    template<typename T>
+    Stream<T>
+    Stream<T>::drop(int n) && {
+        return dropped(std::move(*this), n);
+    }
+
+    // Return an iterator to the first element
+    template<typename T>
+    typename Stream<T>::iterator
+    Stream<T>::begin() const {
+        return iterator(Head, Rest);
+    }
+
+    // Return the end of the Stream
+    template<typename T>
+    typename Stream<T>::iterator
+    Stream<T>::end() const {
+        return iterator();
     }
 
     //
@@ -114,32 +318,52 @@ namespace cpp_collections {
         return cons(value, other);
     }
 
+    // Return the Stream from the first element that matches the predicate
+    // function onwards, filtering its tail lazily
+    template<typename T>
+    Stream<T>
+    Stream<T>::filtered(Stream<T> stream, std::function<bool(T)> func) {
+        while (!func(stream.Head))
+            stream = stream.tail();
+
+        T head = stream.Head;
+        return Stream<T>(head, [stream, func]() mutable -> Stream<T> {
+            // the generator runs once, so it can let go of the match before
+            // looking for the next one
+            Stream<T> next = stream.tail();
+            stream.Rest.reset();
+            return filtered(std::move(next), func);
+        });
+    }
+
     // Return a substream of elements of the Stream that match the
     // predicate function
     template<typename T>
     Stream<T>
-    Stream<T>::filter(std::function<bool(T)> func) const {
-        Stream<T> temp = tail();
-    
-        if (func(Head)) {
-            return Stream<T>(Head, [temp, func]() -> Stream<T> {
-                return temp.filter(func);
-            });
-        }
-        return temp.filter(func);
+    Stream<T>::filter(std::function<bool(T)> func) const & {
+        return filtered(*this, func);
+    }
+
+    // Return a substream of elements of the Stream that match the
+    // predicate function, without keeping the skipped elements
+    template<typename T>
+    Stream<T>
+    Stream<T>::filter(std::function<bool(T)> func) && {
+        return filtered(std::move(*this), func);
     }
 
     // Return the Stream that results from the transformation of each
-    // element in the original Stream
+    // element in the original Stream. The tail of the original Stream is
+    // only computed when the tail of the result is.
     template<typename T>
     template<typename Function>
     Stream<typename std::result_of<Function(T)>::type>
     Stream<T>::map(Function func) const {
         using return_type = typename std::result_of<Function(T)>::type;
 
-        Stream<T> temp = tail();
+        Stream<T> temp = *this;
         return Stream<return_type>(func(Head), [temp, func]() -> Stream<return_type> {
-            return temp.map(func);
+            return temp.tail().map(func);
         });
     }
     
@@ -204,11 +428,8 @@ namespace cpp_collections {
     Stream<std::tuple<U...>>
     zip(Stream<U>... other_stream) {
         using return_type = std::tuple<U...>;
-  
-        std::allocator<return_type> alloc;
-        return_type *tmp = alloc.allocate(1);
-        alloc.construct(tmp, std::move(other_stream.head())...);
-        return Stream<return_type>(*tmp, [=]() -> Stream<return_type> {
+
+        return Stream<return_type>(return_type(other_stream.head()...), [=]() -> Stream<return_type> {
             return zip(other_stream.tail()...); 
         });
     }
@@ -220,10 +441,7 @@ namespace cpp_collections {
     zipWith(Function func, Stream<U>... other_stream) {
         using return_type = typename std::result_of<Function(U...)>::type;
 
-        std::allocator<return_type> alloc;
-        return_type *tmp = alloc.allocate(1);
-        alloc.construct(tmp, func(other_stream.head()...));
-        return Stream<return_type>(*tmp, [=]() -> Stream<return_type> {
+        return Stream<return_type>(func(other_stream.head()...), [=]() -> Stream<return_type> {
             return zipWith(func, other_stream.tail()...);                
         });
     }
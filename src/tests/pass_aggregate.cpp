@@ -0,0 +1,44 @@
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+struct Stats {
+    long long sum;
+    int count;
+    int min;
+    int max;
+};
+
+int main() {
+    auto ints = Collection<int>(std::vector<int> {4, -2, 9, 3});
+
+    auto count = ints.aggregate(0,
+        [](int acc, int) { return acc + 1; },
+        [](int x, int y) { return x + y; }, 3);
+    assert(count == 4);
+
+    // the accumulator type needn't match the element type
+    auto seq = [](Stats s, int x) {
+        return Stats{s.sum + x, s.count + 1, std::min(s.min, x), std::max(s.max, x)};
+    };
+    auto comb = [](Stats a, Stats b) {
+        return Stats{a.sum + b.sum, a.count + b.count,
+                     std::min(a.min, b.min), std::max(a.max, b.max)};
+    };
+    Stats init {0, 0, 1 << 30, -(1 << 30)};
+
+    Stats s = ints.aggregate(init, seq, comb);
+    assert(s.sum == 14 && s.count == 4 && s.min == -2 && s.max == 9);
+
+    Stats big = range(100000).aggregate(init, seq, comb, 4);
+    assert(big.sum == 4999950000LL);
+    assert(big.count == 100000 && big.min == 0 && big.max == 99999);
+
+    Stats empty = Collection<int>().aggregate(init, seq, comb);
+    assert(empty.count == 0);
+}
@@ -0,0 +1,84 @@
+#include <vector>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+struct alignas(64) Wide {
+    double value;
+};
+
+int main() {
+    Arena arena(1 << 12);
+    Collection<int> result;
+
+    for (int round = 0; round < 3; round++) {
+        ScopedArena scope(arena);
+        auto evens = range(1000)
+            .map([](int x) { return x * 3; })
+            .filter([](int x) { return x % 2 == 0; });
+        auto sums = zipWith([](int x, int y) { return x + y; }, evens, evens.tail());
+        result = sums.materialize();
+    }
+    // the blocks of the first round are reused by the others
+    std::size_t capacity = arena.capacity();
+    assert(capacity > 0);
+    {
+        ScopedArena scope(arena);
+        auto again = range(1000).map([](int x) { return x * 3; });
+        assert(again.size() == 1000);
+    }
+    assert(arena.capacity() == capacity);
+
+    // the materialized result lives on the heap, past the arena's release
+    assert(result.size() == 499);
+    assert(result.head() == 6);
+    assert(result.last() == 5982);
+
+    // allocations respect the alignment of the element type
+    {
+        ScopedArena scope(256);
+        // an odd number of bytes leaves the next allocation unaligned
+        auto small = range(67).map([](int x) { return char(x); });
+        assert(small.size() == 67);
+        auto wide = range(5).map([](int x) { return Wide{double(x)}; });
+        assert(reinterpret_cast<std::uintptr_t>(wide.lazy().stage().Begin) % 64 == 0);
+        assert(wide.last().value == 4.0);
+    }
+
+    // a thread waiting with an arena in scope runs other callers' tasks
+    // without handing them its arena
+    {
+        ThreadPool pool(1);
+        std::atomic<bool> done(false);
+        std::atomic<int> stolen(0), leaked(0);
+        std::thread::id waiter = std::this_thread::get_id();
+        std::thread other([&]() {
+            pool.parallel_for(0, 64, 64, 3, [&](int, int, int) {
+                if (std::this_thread::get_id() == waiter)
+                    stolen++;
+                if (Arena::current() != nullptr)
+                    leaked++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+            done = true;
+        });
+        ScopedArena scope(arena);
+        while (!done)
+            if (!pool.run_pending_task())
+                std::this_thread::yield();
+        other.join();
+        assert(stolen > 0);
+        assert(leaked == 0);
+        assert(Arena::current() == &arena);
+    }
+
+    // without an arena Collections use the heap as before
+    assert(Arena::current() == nullptr);
+    assert(range(5).map([](int x) { return x + 1; }) == range(1, 6));
+}
@@ -0,0 +1,70 @@
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+#include "../chunked.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto a = range(0, 1000);
+    auto b = range(1000, 2500);
+
+    // splitting into chunks shares the Collection's elements
+    auto chunked = ChunkedCollection<int>(a, 300);
+    assert(chunked.size() == 1000);
+    assert(chunked.chunk_count() == 4);
+    assert(chunked.chunk(3).size() == 100);
+    assert(chunked[299] == 299);
+    assert(chunked[300] == 300);
+
+    // concat and append splice chunks together
+    auto joined = concat(chunked, b, ChunkedCollection<int>(range(2500, 3000), 128));
+    assert(joined.size() == 3000);
+    assert(joined.chunk_count() == 4 + 1 + 4);
+    assert(joined.compact() == range(3000));
+    assert(chunked.append(b).compact() == range(2500));
+    assert(chunked.append(Collection<int>()).chunk_count() == 4);
+
+    // operations run chunk by chunk
+    auto add = [](int x, int y) { return x + y; };
+    assert(joined.map([](int x) { return x * 2; }).compact() == range(3000).map([](int x) { return x * 2; }));
+    assert(joined.tmap([](int x) { return x + 1; }, 4).compact() == range(1, 3001));
+    assert(joined.filter([](int x) { return x % 1000 == 0; }).compact() ==
+        Collection<int>(std::vector<int> {0, 1000, 2000}));
+    assert(joined.reduceLeft(add) == 4498500);
+    assert(joined.treduce(add, 4) == joined.reduceLeft(add));
+    assert(joined.foldLeft(add, 10) == joined.reduceLeft(add) + 10);
+    assert(joined.sum() == joined.reduceLeft(add));
+    assert(joined.sum(4) == joined.sum());
+
+    long count = 0;
+    joined.each([&](int x) { count += x == count; });
+    assert(count == 3000);
+
+    auto empty = ChunkedCollection<int>();
+    assert(empty.size() == 0);
+    assert(empty.compact().size() == 0);
+
+    // concatenating empty inputs leaves nothing to reduce
+    auto nothing = concat(empty, Collection<int>(), empty);
+    assert(nothing.chunk_count() == 0);
+    int refused = 0;
+    try { nothing.reduceLeft(std::plus<int>()); } catch (const std::length_error&) { refused++; }
+    try { nothing.treduce(std::plus<int>(), 4); } catch (const std::length_error&) { refused++; }
+    assert(refused == 2);
+
+    // chunks sharing one buffer can add up to more elements than a
+    // Collection can hold, which compact refuses to copy
+    auto block = range(1 << 20).materialize();
+    std::vector<Collection<int>> blocks(2049, block);
+    auto huge = ChunkedCollection<int>(blocks);
+    assert(huge.size() == 2049L << 20);
+    bool threw = false;
+    try {
+        huge.compact();
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw);
+}
@@ -0,0 +1,55 @@
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include <cassert>
+
+#include "../chunked_stream.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // chunked Streams hold the same elements as Streams of single elements
+    auto squares = [](long x) { return x * x; };
+    auto even = [](long x) { return x % 2 == 0; };
+    assert(chunked_from(1L).map(squares).take(5000) == from(1L).map(squares).take(5000));
+    assert(chunked_from(0L, 3L, 100).filter(even).take(1000) == from(0L, 3L).filter(even).take(1000));
+    assert(chunked_from(7L).head() == 7);
+    assert(chunked_from(1, 1, 16).take(0).size() == 0);
+
+    auto halve = [](int x) { return x / 2; };
+    assert(chunked_iterate(1 << 20, halve, 8).take(22) == iterate(1 << 20, halve).take(22));
+    int counter = 0;
+    auto counted = chunked_generate([&counter]() { return counter++; }, 10);
+    assert(counted.take(25) == from(0).take(25));
+    assert(counted.take(25) == from(0).take(25));
+    assert(chunked_repeat(4, 3).take(10) == repeat(4).take(10));
+
+    // sparse filters skip whole empty blocks
+    auto sparse = chunked_from(0).filter([](int x) { return x % 100000 == 0; });
+    assert(sparse.take(3) == Collection<int>(std::vector<int> {0, 100000, 200000}));
+
+    // blocks that don't line up are cut where the shortest one ends
+    auto odds = chunked_from(0, 1, 7).filter([](int x) { return x % 2 == 1; });
+    auto threes = chunked_from(0, 3, 5);
+    auto sums = zipWith([](int a, int b) { return a + b; }, odds, threes).take(100);
+    assert(sums == zipWith([](int a, int b) { return a + b; },
+        from(1, 2), from(0, 3)).take(100));
+    auto pairs = zip(odds, threes).take(50);
+    assert(pairs[49] == std::make_tuple(99, 147));
+
+    // any Stream of Collections can be used as blocks, skipping empty ones
+    std::function<Stream<Collection<int>>(int)> growing = [&](int n) -> Stream<Collection<int>> {
+        return Stream<Collection<int>>(range(n).materialize(), [=]() { return growing(n + 1); });
+    };
+    auto triangle = ChunkedStream<int>(growing(0));
+    assert(triangle.take(6) == Collection<int>(std::vector<int> {0, 0, 1, 0, 1, 2}));
+
+    // the sources reject block sizes they could never fill
+    bool threw = false;
+    try {
+        chunked_repeat(1, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+}
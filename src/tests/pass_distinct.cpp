@@ -0,0 +1,53 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // elements keep the order they first appear in
+    auto words = Collection<std::string>(std::vector<std::string> {
+        "pear", "fig", "pear", "kiwi", "fig", "lime"});
+    assert(words.distinct().vector() == std::vector<std::string>({"pear", "fig", "kiwi", "lime"}));
+
+    auto a = Collection<int>(std::vector<int> {5, 1, 5, 3, 2, 3, 9});
+    auto b = Collection<int>(std::vector<int> {3, 9, 9, 4, 5});
+    assert(a.intersect(b) == Collection<int>(std::vector<int> {5, 3, 9}));
+    assert(a.union_(b) == Collection<int>(std::vector<int> {5, 1, 3, 2, 9, 4}));
+    assert(a.diff(b) == Collection<int>(std::vector<int> {1, 2}));
+    assert(b.diff(a) == Collection<int>(std::vector<int> {4}));
+
+    // the parallel mode finds the same elements in the same order
+    auto numbers = range(300000).map([](int x) { return int(x * 7919LL % 100003); });
+    auto others = range(200000).map([](int x) { return int(x * 104729LL % 150001); });
+    auto distinct = numbers.distinct();
+    std::set<int> seen;
+    std::vector<int> expected;
+    numbers.each([&](int x) {
+        if (seen.insert(x).second)
+            expected.push_back(x);
+    });
+    assert(distinct.vector() == expected);
+
+    std::set<int> other_set;
+    others.each([&](int x) { other_set.insert(x); });
+    auto in_others = distinct.filter([&](int x) { return other_set.count(x) > 0; });
+    auto not_in_others = distinct.filter([&](int x) { return other_set.count(x) == 0; });
+    for (int threads : {2, 4}) {
+        assert(numbers.distinct(threads) == distinct);
+        assert(numbers.intersect(others, threads) == in_others);
+        assert(numbers.diff(others, threads) == not_in_others);
+        assert(numbers.union_(others, threads) == numbers.union_(others));
+    }
+    assert(numbers.union_(others).size() == int(seen.size() + others.diff(numbers).size()));
+
+    // empty Collections and Ranges
+    assert(Collection<int>().distinct(4).size() == 0);
+    assert(Collection<int>().intersect(a).size() == 0);
+    assert(a.diff(Collection<int>()) == a.distinct());
+    assert(range(10).distinct() == range(10).materialize());
+    assert(range(10).intersect(a) == Collection<int>(std::vector<int> {1, 2, 3, 5, 9}));
+}
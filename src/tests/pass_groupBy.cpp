@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+// counts the values a hash table default constructs
+int constructed = 0;
+
+struct Counted {
+    int count;
+
+    Counted() : count(0) { constructed++; };
+};
+
+struct Sale {
+    int store;
+    double amount;
+};
+
+int main() {
+    // groups keep the order keys first appear in, and the order of elements
+    auto words = Collection<std::string>(std::vector<std::string> {
+        "apple", "bean", "avocado", "cherry", "banana", "apricot"});
+    auto by_letter = words.groupBy([](const std::string& w) { return w[0]; });
+    assert(by_letter.size() == 3);
+    assert(by_letter[0].first == 'a');
+    assert(by_letter[0].second.vector() == std::vector<std::string>({"apple", "avocado", "apricot"}));
+    assert(by_letter[1].first == 'b');
+    assert(by_letter[2].second.size() == 1);
+
+    auto counts = range(10).countBy([](int x) { return x % 3; });
+    assert(counts.size() == 3);
+    assert(counts[0] == std::make_pair(0, 4));
+    assert(counts[1] == std::make_pair(1, 3));
+    assert(counts[2] == std::make_pair(2, 3));
+
+    // the first value of a key is used as it is, not combined with a default
+    auto sales = range(1000).map([](int i) { return Sale{i % 7, -1.0 - i}; });
+    auto smallest = sales.reduceByKey(
+        [](Sale s) { return s.store; },
+        [](Sale s) { return s.amount; },
+        [](double a, double b) { return std::min(a, b); });
+    assert(smallest.size() == 7);
+    assert(smallest[0] == std::make_pair(0, -995.0));
+
+    // values returned by reference are combined as values
+    auto largest = sales.reduceByKey(
+        [](const Sale& s) { return s.store; },
+        [](const Sale& s) -> const double& { return s.amount; },
+        [](double a, double b) { return std::max(a, b); });
+    assert(largest[0] == std::make_pair(0, -1.0));
+
+    // the parallel mode finds the same groups, with each group in order
+    std::map<int, int> expected;
+    auto numbers = range(200000).map([](int x) { return (x * 7919) % 10007; });
+    numbers.each([&](int x) { expected[x % 5000]++; });
+    for (int threads : {2, 4}) {
+        auto parallel_counts = numbers.countBy([](int x) { return x % 5000; }, threads);
+        assert(parallel_counts.size() == 5000);
+        std::map<int, int> found;
+        parallel_counts.each([&](std::pair<int, int> p) { found[p.first] = p.second; });
+        assert(found == expected);
+
+        auto groups = numbers.groupBy([](int x) { return x % 5000; }, threads);
+        assert(groups.size() == 5000);
+        groups.each([&](const std::pair<int, Collection<int>>& group) {
+            assert(group.second.size() == expected[group.first]);
+            assert(group.second.count([&](int x) { return x % 5000 != group.first; }) == 0);
+        });
+        auto list = groups.vector();
+        auto first = std::find_if(list.begin(), list.end(),
+            [](const std::pair<int, Collection<int>>& g) { return g.first == 0; });
+        assert(first->second.vector() == numbers.filter([](int x) { return x % 5000 == 0; }).vector());
+
+        auto sums = numbers.reduceByKey(
+            [](int x) { return x % 2; },
+            [](int x) { return (long long) x; },
+            [](long long a, long long b) { return a + b; },
+            threads);
+        assert(sums.size() == 2);
+        assert(sums[0].second + sums[1].second == numbers.foldLeft(
+            [](long long a, int x) { return a + x; }, 0LL));
+    }
+
+    // the parallel mode inside an arena grows its groups off the arena,
+    // which only the calling thread may allocate from
+    {
+        Arena arena;
+        ScopedArena scope(arena);
+        auto groups = numbers.groupBy([](int x) { return x % 5000; }, 4);
+        assert(groups.size() == 5000);
+        groups.each([&](const std::pair<int, Collection<int>>& group) {
+            assert(group.second.size() == expected[group.first]);
+        });
+        assert(arena.capacity() > 0);
+    }
+
+    // empty Collections have no groups
+    assert(Collection<int>().countBy([](int x) { return x; }).size() == 0);
+    assert(Collection<int>().groupBy([](int x) { return x; }, 4).size() == 0);
+
+    // the hash table on its own
+    HashTable<std::string, int> table;
+    for (int i = 0; i < 1000; i++)
+        *table.emplace(std::to_string(i % 100), HashTable<std::string, int>::hash(std::to_string(i % 100))).first += 1;
+    assert(table.size() == 100);
+    assert(*table.find("42") == 10);
+    assert(table.find("100") == nullptr);
+
+    // values are only constructed for keys that are inserted, never for the
+    // empty slots of the table
+    HashTable<int, Counted> tally;
+    for (int i = 0; i < 1000; i++)
+        tally.emplace(i % 10, HashTable<int, Counted>::hash(i % 10)).first->count++;
+    assert(tally.size() == 10);
+    assert(tally.find(3)->count == 100);
+    assert(constructed == 10);
+}
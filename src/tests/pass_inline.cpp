@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    static_assert(inline_capacity<int>::value == 16, "16 ints fit inline");
+    static_assert(inline_capacity<std::string>::value == 0, "strings are never inline");
+
+    // small Collections never allocate: anything they did allocate would
+    // come from the arena in scope
+    Arena arena;
+    ScopedArena scope(arena);
+    int sum = range(10)
+        .map([](int x) { return x * 3; })
+        .filter([](int x) { return x % 2 == 0; })
+        .tail()
+        .foldLeft([](int x, int y) { return x + y; }, 0);
+    auto small = range(16).materialize();
+    auto copy = small;
+    auto part = small.slice(2, 5);
+    assert(arena.capacity() == 0);
+    assert(sum == 60);
+
+    // copies of inline elements are independent of each other
+    auto doubled = std::move(copy).map([](int x) { return x * 2; });
+    assert(small == range(16));
+    assert(doubled.last() == 30);
+    assert(part == range(2, 5));
+
+    // larger Collections still share one buffer between their views
+    auto big = range(100).materialize();
+    std::size_t capacity = arena.capacity();
+    assert(capacity > 0);
+    auto view = big.slice(10, 90).tail();
+    assert(arena.capacity() == capacity);
+    assert(view.size() == 79);
+    assert(view.head() == 11);
+
+    // a moved-from Collection is left empty, whether its elements were
+    // inline or in a buffer, and can be assigned to again
+    auto moved = std::move(small);
+    auto taken = Collection<int>();
+    taken = std::move(big);
+    assert(moved.size() == 16 && taken.size() == 100);
+    assert(small.size() == 0 && big.size() == 0);
+    assert(small.vector().empty() && big.begin() == big.end());
+    small = range(3).materialize();
+    big = taken;
+    assert(small.last() == 2 && big.last() == 99);
+
+    // a lazy view of a temporary keeps its inline elements alive
+    auto lazy = range(5).lazy();
+    assert(lazy.map([](int x) { return x + 1; }).vector() == std::vector<int>({1, 2, 3, 4, 5}));
+
+    auto strs = Collection<std::string>(std::vector<std::string> {"a", "b"});
+    assert(strs.tail().head() == "b");
+}
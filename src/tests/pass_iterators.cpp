@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "../cpp_collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // Collections hand their elements to loops and STL algorithms directly
+    auto numbers = Collection<int>(std::vector<int> {5, 3, 8, 1});
+    int total = 0;
+    for (int x : numbers)
+        total += x;
+    assert(total == 17);
+    assert(std::accumulate(numbers.begin(), numbers.end(), 0) == 17);
+    assert(*std::max_element(numbers.begin(), numbers.end()) == 8);
+    assert(std::find(numbers.begin(), numbers.end(), 8) - numbers.begin() == 2);
+    auto view = numbers.slice(1, 3);
+    assert(std::vector<int>(view.begin(), view.end()) == std::vector<int>({3, 8}));
+    auto empty = Collection<int>();
+    assert(empty.begin() == empty.end());
+    auto words = range(300).map([](int x) { return std::to_string(x); });
+    assert(std::count_if(words.begin(), words.end(),
+        [](const std::string& w) { return w.size() == 2; }) == 90);
+
+    // Streams are iterated an element at a time until the loop breaks
+    std::vector<int> squares;
+    for (int x : from(1).map([](int x) { return x * x; })) {
+        if (x > 50)
+            break;
+        squares.push_back(x);
+    }
+    assert(squares == std::vector<int>({1, 4, 9, 16, 25, 36, 49}));
+
+    auto ints = from(0);
+    auto it = ints.begin();
+    auto copy = it++;
+    assert(*copy == 0 && *it == 1 && copy != it);
+    assert(++copy == it);
+    assert(it != ints.end());
+    auto found = std::find_if(ints.begin(), ints.end(), [](int x) { return x * x > 1000; });
+    assert(*found == 32);
+
+    // an iterator over a temporary Stream keeps only its current element
+    int calls = 0;
+    long last = 0;
+    for (auto i = iterate(0L, [&calls](long x) { calls++; return x + 1; }).begin(); *i != 1000000; ++i)
+        last = *i;
+    assert(last == 999999 && calls == 1000000);
+
+    // takeWhile stops at the first element that doesn't match, and drop
+    // skips the start of a Stream
+    calls = 0;
+    auto counted = iterate(1, [&calls](int x) { calls++; return x * 2; });
+    assert(counted.takeWhile([](int x) { return x < 100; }) ==
+        Collection<int>(std::vector<int> {1, 2, 4, 8, 16, 32, 64}));
+    assert(calls == 7);
+    assert(counted.drop(3).take(2) == Collection<int>(std::vector<int> {8, 16}));
+    assert(from(0).drop(200000).head() == 200000);
+    assert(counted.takeWhile([](int x) { return x < 0; }).size() == 0);
+
+    // and the same for lazy Streams
+    auto evens = lazy_from(0).filter([](int x) { return x % 2 == 0; });
+    std::vector<int> some;
+    for (int x : evens.drop(2)) {
+        if (some.size() == 3)
+            break;
+        some.push_back(x);
+    }
+    assert(some == std::vector<int>({4, 6, 8}));
+    assert(evens.takeWhile([](int x) { return x < 10; }) ==
+        Collection<int>(std::vector<int> {0, 2, 4, 6, 8}));
+    assert(*std::find(evens.begin(), evens.end(), 42) == 42);
+}
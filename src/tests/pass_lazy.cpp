@@ -0,0 +1,58 @@
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto square = [](int x) { return x * x; };
+    auto even = [](int x) { return x % 2 == 0; };
+    auto add = [](int x, int y) { return x + y; };
+
+    auto ints = range(1, 11).materialize();
+
+    // a fused pipeline matches the eager one
+    int eager = ints.map(square).filter(even).map(square).reduceLeft(add);
+    int fused = ints.lazy().map(square).filter(even).map(square).reduceLeft(add);
+    assert(fused == eager);
+
+    auto evens = ints.lazy().filter(even).collect();
+    assert(evens == Collection<int>(std::vector<int> {2, 4, 6, 8, 10}));
+
+    // slice counts the elements that reach it, and stops the pipeline early
+    int calls = 0;
+    auto sliced = ints.lazy().map([&](int x) { calls++; return x; })
+                      .filter(even).slice(1, 3).vector();
+    assert(sliced == std::vector<int>({4, 6}));
+    assert(calls == 6);
+
+    auto doubles = ints.lazy().map([](int x) { return x * 0.5; }).collect();
+    assert(doubles[1] == 1.0);
+
+    auto other = range(3);
+    auto zipped = ints.lazy().zipWith(add, other).vector();
+    assert(zipped == std::vector<int>({1, 3, 5}));
+
+    assert(ints.lazy().foldLeft(add, 100) == 155);
+
+    // a view of a temporary keeps its elements alive
+    auto view = range(5).lazy().map(square);
+    assert(view.vector() == std::vector<int>({0, 1, 4, 9, 16}));
+
+    int sum = 0;
+    view.each([&](int x) { sum += x; });
+    assert(sum == 30);
+
+    // and so does zipping with a temporary Collection, inline or not
+    auto small = ints.lazy().zipWith(add, range(3).materialize());
+    auto large = range(1000).lazy().zipWith(add, range(1000).materialize().map(square));
+    assert(small.vector() == std::vector<int>({1, 3, 5}));
+    assert(large.reduceLeft(add) == 499500 + 332833500);
+
+    // a Collection moved into a view is left empty
+    auto moved = range(1000).materialize();
+    auto moved_view = std::move(moved).lazy();
+    assert(moved.size() == 0 && moved.vector().empty());
+    assert(moved_view.reduceLeft(add) == 499500);
+}
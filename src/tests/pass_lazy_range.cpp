@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // reductions over a Range generate the elements rather than storing them:
+    // any Collection they built would allocate from the arena in scope
+    Arena arena;
+    ScopedArena scope(arena);
+    auto big = range(int64_t(1), int64_t(100000001));
+    assert(big.size() == 100000000);
+    assert(big.sum() == int64_t(5000000050000000LL));
+    assert(big.min() == 1);
+    assert(big.max() == 100000000);
+    assert(big.minmax() == std::make_pair(int64_t(1), int64_t(100000000)));
+    assert(big.slice(10, 20).sum() == 155);
+    assert(range(1, 1001).reduceLeft([](int x, int y) { return x + y; }) == 500500);
+    assert(range(10).foldLeft([](int x, int y) { return x * 2 + y; }, 0) == 1013);
+    assert(range(100).count([](int x) { return x % 7 == 0; }) == 15);
+    assert(range(1, 6).lazy().map([](int x) { return x * x; }).reduceLeft(
+        [](int x, int y) { return x + y; }) == 55);
+    assert(range(1000, 2000).tail().init().head() == 1001);
+    assert(range(1000, 2000).last() == 1999);
+    assert(arena.capacity() == 0);
+    assert(range(100000).count([](int x) { return x % 7 == 0; }, 4) == 14286);
+
+    // closed forms agree with summing the elements
+    assert(range(-7, 13).sum() == range(-7, 13).materialize().sum());
+    assert(range(0.5, 10.5).sum() == 50.0);
+    assert(range(short(-3), short(4)).sum() == 0);
+
+    // map and filter only allocate their results
+    auto squares = range(1, 5).map([](int x) { return x * x; });
+    assert(squares == Collection<int>(std::vector<int> {1, 4, 9, 16}));
+    auto evens = range(100).filter([](int x) { return x % 2 == 0; });
+    assert(evens.size() == 50);
+    assert(evens.last() == 98);
+
+    // a Range converts to a Collection wherever one is needed
+    Collection<int> c = range(3, 6);
+    assert(c == range(3, 6));
+    assert(range(3, 6) == c);
+    assert(zipWith([](int x, int y) { return x + y; }, range(3), c) ==
+        Collection<int>(std::vector<int> {3, 5, 7}));
+    assert(concat(range(2), c) == Collection<int>(std::vector<int> {0, 1, 3, 4, 5}));
+    assert(range(4).scanLeft([](int x, int y) { return x + y; }, 0) ==
+        Collection<int>(std::vector<int> {0, 0, 1, 3, 6}));
+    assert(range(0).size() == 0);
+    assert(range(5, 2).size() == 0);
+
+    // an empty Range has no extremes to return
+    int threw = 0;
+    for (int op = 0; op < 4; op++) {
+        try {
+            auto empty = range(5, 2);
+            if (op == 0) empty.last();
+            if (op == 1) empty.min();
+            if (op == 2) empty.max();
+            if (op == 3) empty.minmax();
+        } catch (const std::length_error&) {
+            threw++;
+        }
+    }
+    assert(threw == 4);
+}
@@ -0,0 +1,47 @@
+#include <vector>
+#include <cassert>
+
+#include "../lazy_stream.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // lazy Streams hold the same elements as Streams
+    auto square = [](long x) { return x * x; };
+    auto even = [](long x) { return x % 2 == 0; };
+    auto squares = lazy_from(1L).map(square).filter(even);
+    assert(squares.take(1000) == from(1L).map(square).filter(even).take(1000));
+    assert(squares.head() == 4);
+    // every terminal operation starts over
+    assert(squares.take(3) == squares.take(3));
+    assert(lazy_from(10, -2).take(4) == Collection<int>(std::vector<int> {10, 8, 6, 4}));
+    assert(lazy_repeat(7).take(3) == repeat(7).take(3));
+    assert(lazy_from(0).take(0).size() == 0);
+
+    // iterate only calls its function for the elements that are taken
+    int calls = 0;
+    auto doubling = lazy_iterate(1, [&calls](int x) { calls++; return 2 * x; });
+    assert(doubling.take(10).last() == 512);
+    assert(calls == 9);
+
+    int counter = 0;
+    auto counted = lazy_generate([&counter]() { return counter++; });
+    assert(counted.take(5) == from(0).take(5));
+    assert(counted.take(5) == from(5).take(5));
+
+    // zipWith pulls from every zipped Stream in turn
+    auto sums = zipWith([](int a, long b, int c) { return a + b + c; },
+        lazy_from(0), squares, lazy_repeat(100));
+    assert(sums.take(3) == Collection<long>(std::vector<long> {104, 117, 138}));
+
+    // converting to a Stream erases the pipeline and runs it on demand
+    Stream<long> erased = squares;
+    assert(erased.tail().head() == 16);
+    assert(erased.take(1000) == squares.take(1000));
+    int erased_calls = 0;
+    Stream<int> powers = lazy_iterate(1, [&erased_calls](int x) { erased_calls++; return 3 * x; })
+        .map([](int x) { return x + 1; });
+    assert(powers.take(4) == Collection<int>(std::vector<int> {2, 4, 10, 28}));
+    assert(powers.take(4) == Collection<int>(std::vector<int> {2, 4, 10, 28}));
+    assert(erased_calls == 3);
+}
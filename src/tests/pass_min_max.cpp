@@ -0,0 +1,57 @@
+#include <stdexcept>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto ints = Collection<int>(std::vector<int> {3, -1, 4, 1, -5, 9, 2});
+    assert(ints.min() == -5);
+    assert(ints.max() == 9);
+    assert(ints.minmax() == std::make_pair(-5, 9));
+
+    // put the extremes at every position of a collection longer than a
+    // vector register
+    for (int i = 0; i < 70; i++) {
+        std::vector<int> v(70, 7);
+        v[i] = -100;
+        v[69 - i] = 100;
+        auto c = Collection<int>(v);
+        assert(c.min() == -100 && c.max() == 100);
+        assert(c.minmax(3) == std::make_pair(-100, 100));
+    }
+
+    auto big = range(-50000, 50001).materialize();
+    assert(big.min(4) == -50000 && big.max(4) == 50000);
+    assert(big.minmax() == std::make_pair(-50000, 50000));
+
+    auto longs = range(int64_t(-3), int64_t(40)).materialize();
+    assert(longs.min() == -3 && longs.max() == 39);
+
+    auto doubles = range(-2.5, 10.5).materialize();
+    assert(doubles.min() == -2.5 && doubles.max() == 9.5);
+    assert(range(33.0f).materialize().max() == 32.0f);
+
+    // an empty Collection has no extremes, on one thread or several
+    int threw = 0;
+    for (int threads : {1, 4}) {
+        Collection<int> empty;
+        try { empty.min(threads); } catch (const std::length_error&) { threw++; }
+        try { empty.max(threads); } catch (const std::length_error&) { threw++; }
+        try { empty.minmax(threads); } catch (const std::length_error&) { threw++; }
+    }
+    assert(threw == 6);
+
+    assert(range(100).count([](int x) { return x % 3 == 0; }) == 34);
+    assert(big.count([](int x) { return x < 0; }, 4) == 50000);
+
+    // by default the predicate is called in order on the calling thread, so
+    // it may keep state
+    std::vector<int> seen;
+    big.count([&](int x) { seen.push_back(x); return true; });
+    assert(seen == big.vector());
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+struct Record {
+    int id;
+    double price;
+};
+
+int main() {
+    const char* input = "pass_mmap_input.bin";
+    const char* output = "pass_mmap_output.bin";
+
+    // write 100,000 records to a file
+    int n = 100000;
+    std::vector<Record> records(n);
+    for (int i = 0; i < n; i++)
+        records[i] = Record{i, i * 0.5};
+    FILE* file = fopen(input, "wb");
+    fwrite(records.data(), sizeof(Record), n, file);
+    fclose(file);
+
+    // the mapped Collection reads the file in place
+    auto mapped = Collection<Record>::mmap(input);
+    assert(mapped.size() == n);
+    assert(mapped[1234].id == 1234);
+    assert(mapped.last().price == (n - 1) * 0.5);
+
+    auto ids = mapped.map([](Record r) { return r.id; });
+    assert(mapped.foldLeft([](long long sum, Record r) { return sum + r.id; }, 0LL) ==
+        (long long)n * (n - 1) / 2);
+    assert(ids.max() == n - 1);
+    assert(mapped.count([](Record r) { return r.price >= 100; }, 4) == n - 200);
+    assert(mapped.treduce([](Record a, Record b) { return a.id > b.id ? a : b; }, 4).id == n - 1);
+
+    // views share the mapping and keep it alive
+    Collection<Record> tail;
+    {
+        auto again = Collection<Record>::mmap(input);
+        tail = again.slice(n - 10, n);
+    }
+    assert(tail.size() == 10);
+    assert(tail[0].id == n - 10);
+
+    // changing a temporary mapped Collection never changes the file
+    auto doubled = Collection<Record>::mmap(input).map([](Record r) {
+        return Record{r.id * 2, r.price};
+    });
+    assert(doubled[10].id == 20);
+    assert(Collection<Record>::mmap(input)[10].id == 10);
+
+    // map into a new file, then read it back
+    auto prices = mapped.tmap([](Record r) { return r.price * 2; }, output, 4);
+    assert(prices.size() == n);
+    assert(prices[10] == 10.0);
+    auto reread = Collection<double>::mmap(output);
+    assert(reread.size() == n);
+    assert(reread.sum() == prices.sum());
+    auto squares = range(10).map([](int x) { return x * x; }, output);
+    assert(Collection<int>::mmap(output) == squares);
+
+    // operations chained on a Collection mapped to an output file copy its
+    // elements instead of changing the file
+    auto negated = range(1000).map([](int x) { return x; }, output)
+        .map([](int x) { return -x; });
+    assert(negated[999] == -999);
+    assert(Collection<int>::mmap(output) == range(1000));
+    auto sorted = range(1000).map([](int x) { return 999 - x; }, output).sort();
+    assert(sorted == range(1000));
+    assert(Collection<int>::mmap(output)[0] == 999);
+
+    // empty files give empty Collections
+    auto empty = range(0).map([](int x) { return x; }, output);
+    assert(empty.size() == 0);
+    assert(Collection<int>::mmap(output).size() == 0);
+
+    // files that don't hold whole elements, or don't exist, are errors
+    file = fopen(output, "wb");
+    fwrite("abc", 1, 3, file);
+    fclose(file);
+    bool threw = false;
+    try {
+        Collection<int>::mmap(output);
+    } catch (const std::length_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try {
+        Collection<int>::mmap("pass_mmap_missing.bin");
+    } catch (const std::system_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::remove(input);
+    std::remove(output);
+}
@@ -0,0 +1,52 @@
+#include <vector>
+#include <string>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+// Counts how often elements get copied rather than moved
+struct Counted {
+    int value;
+    static int copies;
+
+    Counted(int v=0) : value(v) {}
+    Counted(const Counted& other) : value(other.value) { copies++; }
+    Counted(Counted&& other) : value(other.value) {}
+    Counted& operator=(const Counted& other) { value = other.value; copies++; return *this; }
+    Counted& operator=(Counted&& other) { value = other.value; return *this; }
+    bool operator==(const Counted& other) const { return value == other.value; }
+};
+int Counted::copies = 0;
+
+int main() {
+    std::vector<Counted> v;
+    for (int i = 0; i < 10; i++)
+        v.push_back(Counted(i));
+
+    Counted::copies = 0;
+    auto result = Collection<Counted>(std::move(v))
+        .map([](const Counted& c) { return Counted(c.value * 2); })
+        .filter([](const Counted& c) { return c.value % 4 == 0; })
+        .tail()
+        .init()
+        .slice(1, 2);
+    assert(Counted::copies == 0);
+    assert(result.size() == 1);
+    assert(result.head().value == 8);
+
+    // lvalues are left untouched
+    auto ints = range(10).materialize();
+    auto evens = ints.filter([](int x) { return x % 2 == 0; });
+    assert(ints.size() == 10);
+    assert(evens == Collection<int>(std::vector<int> {0, 2, 4, 6, 8}));
+    assert(ints.tail().size() == 9);
+    assert(ints.slice(2, 5) == range(2, 5));
+
+    // temporaries whose element type changes still map correctly
+    auto strs = range(3).materialize().map([](int x) { return std::to_string(x); });
+    assert(strs[2] == "2");
+    assert(range(1, 5).materialize().slice(1, 3) == range(2, 4));
+    assert(range(5).materialize().tail().init() == range(1, 4));
+}
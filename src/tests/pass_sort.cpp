@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+struct Order {
+    int id;
+    double price;
+};
+
+int main() {
+    // a deterministic mix of positive and negative numbers
+    unsigned seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1103515245 + 12345;
+        return int(seed >> 1) - (1 << 30);
+    };
+
+    std::vector<int> ints(100000);
+    for (auto& x : ints)
+        x = next();
+    std::vector<int> expected = ints;
+    std::sort(expected.begin(), expected.end());
+    auto numbers = Collection<int>(ints);
+    assert(numbers.sort().vector() == expected);
+    assert(numbers.sort(1).vector() == expected);
+    assert(numbers.sort(4).vector() == expected);
+    // sorting a copy leaves the original alone
+    assert(numbers.vector() == ints);
+
+    // temporaries are sorted in place unless they are shared
+    auto shared = Collection<int>(ints);
+    auto view = shared.slice(0, 10);
+    assert(std::move(shared).sort().vector() == expected);
+    assert(view[0] == ints[0]);
+    assert(Collection<int>(ints).sort(2).vector() == expected);
+
+    std::vector<double> doubles;
+    for (int i = 0; i < 50000; i++)
+        doubles.push_back(next() / 1000.0);
+    doubles.push_back(-std::numeric_limits<double>::infinity());
+    doubles.push_back(std::numeric_limits<double>::infinity());
+    doubles.push_back(0.0);
+    std::vector<double> sorted_doubles = doubles;
+    std::sort(sorted_doubles.begin(), sorted_doubles.end());
+    assert(Collection<double>(doubles).sort().vector() == sorted_doubles);
+
+    std::vector<int64_t> longs;
+    for (int i = 0; i < 10000; i++)
+        longs.push_back(int64_t(next()) * next());
+    std::vector<int64_t> sorted_longs = longs;
+    std::sort(sorted_longs.begin(), sorted_longs.end());
+    assert(Collection<int64_t>(longs).sort(3).vector() == sorted_longs);
+
+    std::vector<unsigned char> bytes;
+    for (int i = 0; i < 5000; i++)
+        bytes.push_back(next() & 0xff);
+    std::vector<unsigned char> sorted_bytes = bytes;
+    std::sort(sorted_bytes.begin(), sorted_bytes.end());
+    assert(Collection<unsigned char>(bytes).sort().vector() == sorted_bytes);
+
+    // other types are merge sorted
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; i++)
+        words.push_back(std::to_string(next()));
+    std::vector<std::string> sorted_words = words;
+    std::sort(sorted_words.begin(), sorted_words.end());
+    assert(Collection<std::string>(words).sort(4).vector() == sorted_words);
+
+    auto flags = range(3000).map([](int x) { return x % 3 == 0; }).sort();
+    assert(flags.count([](bool x) { return !x; }) == 2000);
+    assert(!flags[1999] && flags[2000]);
+
+    // small Collections
+    assert(Collection<int>(std::vector<int> {3, -1, 2}).sort() == Collection<int>(std::vector<int> {-1, 2, 3}));
+    assert(Collection<int>().sort().size() == 0);
+    assert(range(5, 10).sort() == range(5, 10).materialize());
+
+    // sorting by radix keys keeps equal keys in order
+    std::vector<Order> list;
+    for (int i = 0; i < 20000; i++)
+        list.push_back(Order{i, double(next() % 100)});
+    auto orders = Collection<Order>(list);
+    auto by_price = orders.sortBy([](Order o) { return o.price; });
+    for (int i = 1; i < by_price.size(); i++) {
+        assert(by_price[i - 1].price <= by_price[i].price);
+        if (by_price[i - 1].price == by_price[i].price)
+            assert(by_price[i - 1].id < by_price[i].id);
+    }
+
+    // and stableSortBy keeps them in order for other keys too
+    auto by_name = orders.stableSortBy([](Order o) { return std::to_string(int(o.price)); }, 4);
+    for (int i = 1; i < by_name.size(); i++) {
+        std::string a = std::to_string(int(by_name[i - 1].price));
+        std::string b = std::to_string(int(by_name[i].price));
+        assert(a <= b);
+        if (a == b)
+            assert(by_name[i - 1].id < by_name[i].id);
+    }
+
+    auto descending = range(-500, 500).sortBy([](int x) { return -x; });
+    assert(descending[0] == 499 && descending.last() == -500);
+    auto by_word = orders.sortBy([](Order o) { return std::to_string(o.id); });
+    assert(by_word[0].id == 0 && by_word[1].id == 1 && by_word[2].id == 10);
+}
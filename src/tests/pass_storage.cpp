@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <stdexcept>
+#include <tuple>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+struct Point {
+    float x, y;
+};
+
+int main() {
+    const char* path = "pass_storage.bin";
+
+    // elements round trip, with bounds for every block
+    auto doubles = range(0, 200000).map([](int x) { return (x % 1000) * 0.5; });
+    doubles.save(path);
+    auto loaded = Collection<double>::load(path, true);
+    assert(loaded == doubles);
+
+    StoredFile file(path);
+    assert(file.size() == 200000);
+    assert(file.columns() == 1);
+    auto bounds = file.bounds<double>(0);
+    assert(bounds.size() == 4);
+    assert(bounds[0] == std::make_pair(0.0, 499.5));
+    assert(bounds[3].second == 499.5);
+
+    // changing a loaded temporary leaves the file alone
+    auto doubled = Collection<double>::load(path).map([](double x) { return x * 2; });
+    assert(doubled[3] == 3.0);
+    assert(Collection<double>::load(path)[3] == 1.5);
+
+    // other trivially copyable types are stored without bounds
+    auto points = range(1000).map([](int i) { return Point{float(i), -float(i)}; });
+    points.save(path);
+    auto points_loaded = Collection<Point>::load(path, true);
+    assert(points_loaded.size() == 1000);
+    assert(points_loaded[999].y == -999.0f);
+    bool threw = false;
+    try {
+        StoredFile(path).bounds<Point>(0);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // tuples are stored one column per element, and read back either way
+    auto ints = range(100);
+    auto halves = range(0, 100).map([](int x) { return x * 0.5; });
+    auto flags = range(100).map([](int x) { return x % 3 == 0; });
+    Collection<std::tuple<int, double, bool>> rows = zip(ints, halves, flags);
+    rows.save(path);
+    assert(StoredFile(path).columns() == 3);
+    auto rows_loaded = Collection<std::tuple<int, double, bool>>::load(path, true);
+    assert(rows_loaded == rows);
+    auto columns = ZippedView<int, double, bool>::load(path, true);
+    assert(columns.size() == 100);
+    assert(columns[99] == std::make_tuple(99, 49.5, true));
+    assert(StoredFile(path).bounds<int>(0)[0] == std::make_pair(0, 99));
+
+    zip(ints, halves).slice(10, 20).save(path);
+    auto pairs = Collection<std::tuple<int, double>>::load(path);
+    assert(pairs.size() == 10);
+    assert(pairs[0] == std::make_tuple(10, 5.0));
+
+    // empty Collections round trip
+    Collection<int>().save(path);
+    assert(Collection<int>::load(path, true).size() == 0);
+
+    // loading as another type, or a corrupt file, is an error
+    range(0, 100000).materialize().save(path);
+    threw = false;
+    try {
+        Collection<float>::load(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    FILE* f = fopen(path, "r+b");
+    fseek(f, 4096, SEEK_SET);
+    fputc(0x7f, f);
+    fclose(f);
+    assert(Collection<int>::load(path).size() == 100000);
+    threw = false;
+    try {
+        Collection<int>::load(path, true);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    f = fopen(path, "wb");
+    fputs("not a Collection", f);
+    fclose(f);
+    threw = false;
+    try {
+        Collection<int>::load(path);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::remove(path);
+}
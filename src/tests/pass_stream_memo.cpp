@@ -0,0 +1,46 @@
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <cassert>
+
+#include "../streams.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // every tail is computed once, however often the Stream is traversed
+    int calls = 0;
+    auto squares = iterate(1, [&calls](int x) { calls++; return x + 1; })
+        .map([](int x) { return x * x; });
+    auto first = squares.take(100);
+    int first_calls = calls;
+    assert(squares.take(100) == first);
+    assert(squares.tail().tail().head() == 9);
+    assert(calls == first_calls);
+
+    // copies share their tails, so zipping a Stream with itself is free
+    calls = 0;
+    auto ints = iterate(0, [&calls](int x) { calls++; return x + 1; });
+    auto pairs = zip(ints, ints).take(50);
+    assert(std::get<0>(pairs[49]) == 49 && std::get<1>(pairs[49]) == 49);
+    assert(calls == 49);
+
+    // a tail asked for by many threads at once is still computed once
+    std::atomic<int> shared_calls(0);
+    auto counted = iterate(0, [&shared_calls](int x) { shared_calls++; return x + 1; });
+    std::thread a([&]() { assert(counted.take(10000).last() == 9999); });
+    std::thread b([&]() { assert(counted.take(10000).last() == 9999); });
+    a.join();
+    b.join();
+    assert(shared_calls == 9999);
+
+    // a long computed Stream is released without recursing through it
+    {
+        auto numbers = from(0);
+        assert(numbers.take(1000000).last() == 999999);
+    }
+
+    // cons'd Streams keep working
+    auto more = 5 & (6 & ints);
+    assert(more.take(4) == Collection<int>(std::vector<int> {5, 6, 0, 1}));
+}
@@ -0,0 +1,26 @@
+#include <vector>
+#include <cassert>
+
+#include "../streams.h"
+
+using namespace cpp_collections;
+
+int main() {
+    // skipping many elements between matches doesn't grow the stack
+    auto sparse = from(0).filter([](int x) { return x % 100000 == 99999; });
+    assert(sparse.take(3) == Collection<int>(std::vector<int> {99999, 199999, 299999}));
+
+    // filtering a filtered Stream, and a Stream that is kept around
+    auto numbers = from(1);
+    auto odd_squares = numbers.map([](int x) { return x * x; })
+        .filter([](int x) { return x % 2 == 1; })
+        .filter([](int x) { return x % 3 == 0; });
+    assert(odd_squares.take(3) == Collection<int>(std::vector<int> {9, 81, 225}));
+    assert(numbers.filter([](int x) { return x > 100000; }).head() == 100001);
+
+    // taking elements doesn't look past the last one
+    int calls = 0;
+    auto counted = iterate(0, [&calls](int x) { calls++; return x + 1; });
+    assert(counted.filter([](int x) { return x % 10 == 0; }).take(2).last() == 10);
+    assert(calls == 10);
+}
@@ -0,0 +1,31 @@
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto ints = Collection<int>(std::vector<int> {3, 1, 4, 1, 5});
+    assert(ints.sum() == 14);
+
+    // lengths that leave leftovers after every vector width
+    for (int n = 1; n < 100; n++)
+        assert(range(n).materialize().sum() == n * (n - 1) / 2);
+
+    auto big = range(10003).materialize();
+    assert(big.sum(4) == big.reduceLeft([](int x, int y) { return x + y; }));
+
+    assert(range(int64_t(1), int64_t(200001)).materialize().sum() == int64_t(20000100000LL));
+    assert(range(1000.0f).materialize().sum() == 499500.0f);
+    assert(range(100000.0).materialize().sum(4) == 4999950000.0);
+
+    // types without vector kernels use the scalar loop
+    assert(range(short(10)).materialize().sum() == 45);
+    auto strs = Collection<std::string>(std::vector<std::string> {"a", "b", "c"});
+    assert(strs.sum() == "abc");
+
+    assert(Collection<int>().sum() == 0);
+}
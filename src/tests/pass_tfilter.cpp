@@ -0,0 +1,20 @@
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto even = [](int x) { return x % 2 == 0; };
+    auto ints = Collection<int>(std::vector<int> {2, 3, 4, 5});
+
+    auto ints2 = ints.tfilter(even, 3);
+    assert(ints2 == Collection<int>(std::vector<int> {2, 4}));
+
+    auto big = range(10007);
+    assert(big.tfilter(even, 4) == big.filter(even));
+    assert(big.tfilter([](int x) { return x < 0; }).size() == 0);
+    assert(big.tfilter([](int x) { return x >= 0; }) == big);
+    assert(Collection<int>().tfilter(even).size() == 0);
+}
@@ -0,0 +1,68 @@
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    ThreadPool pool(3);
+    assert(pool.size() == 3);
+
+    // every index is visited exactly once, uneven chunks included
+    std::vector<int> hits(103, 0);
+    pool.parallel_for(0, 103, 4, 4, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++)
+            hits[i]++;
+    });
+    for (int h : hits)
+        assert(h == 1);
+
+    // chunks keep their index and bounds however the ranges get stolen
+    std::vector<int> bounds(10, -1);
+    pool.parallel_for(0, 25, 10, 4, [&](int chunk, int begin, int end) {
+        bounds[chunk] = begin;
+        assert(end - begin == (chunk < 5 ? 3 : 2));
+    });
+    for (int i = 1; i < 10; i++)
+        assert(bounds[i] > bounds[i - 1]);
+
+    // nested calls from inside a worker complete without deadlocking
+    std::atomic<int> total(0);
+    pool.parallel_for(0, 8, 8, 4, [&](int, int, int) {
+        pool.parallel_for(0, 10, 5, 4, [&](int, int begin, int end) {
+            total += end - begin;
+        });
+    });
+    assert(total == 80);
+
+    // more chunks than elements, and an empty range
+    int calls = 0;
+    pool.parallel_for(0, 2, 8, 4, [&](int, int begin, int end) {
+        assert(end - begin == 1);
+    });
+    pool.parallel_for(0, 0, 4, 4, [&](int, int, int) { calls++; });
+    assert(calls == 0);
+
+    // one thread runs every chunk on the calling thread
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallel_for(0, 64, 16, 1, [&](int, int, int) {
+        assert(std::this_thread::get_id() == caller);
+    });
+
+    // no more than 'threads' threads run chunks at once
+    std::atomic<int> running(0), most(0);
+    pool.parallel_for(0, 64, 16, 2, [&](int, int, int) {
+        int now = ++running;
+        for (int seen = most; now > seen && !most.compare_exchange_weak(seen, now); ) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        running--;
+    });
+    assert(most <= 2);
+
+    // the shared pool is started once and reused
+    assert(&thread_pool() == &thread_pool());
+}
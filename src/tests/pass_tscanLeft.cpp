@@ -0,0 +1,23 @@
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+
+int main(){
+    auto ints = Collection<int>(std::vector<int> {1, 2, 3, 4});
+
+    auto add = [](int x, int y) {return x+y;};
+
+    auto ints2 = ints.tscanLeft(add, 1, 3);
+
+    assert(ints2 == Collection<int>(std::vector<int> {1, 2, 4, 7, 11}));
+
+    auto big = range(10007);
+    assert(big.tscanLeft(add, 5, 4) == big.scanLeft(add, 5));
+    assert(Collection<int>().tscanLeft(add, 7) == Collection<int>(std::vector<int> {7}));
+    assert(Collection<int>().tscanLeft(add, 7, 4) == Collection<int>(std::vector<int> {7}));
+}
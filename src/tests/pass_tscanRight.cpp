@@ -0,0 +1,23 @@
+#include <vector>
+#include <iostream>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+
+int main(){
+    auto ints = Collection<int>(std::vector<int> {1, 2, 3, 4});
+
+    auto add = [](int x, int y) {return x+y;};
+
+    auto ints2 = ints.tscanRight(add, 1, 3);
+
+    assert(ints2 == Collection<int>(std::vector<int> {11, 10, 8, 5, 1}));
+
+    auto big = range(10007);
+    assert(big.tscanRight(add, 5, 4) == big.scanRight(add, 5));
+    assert(Collection<int>().tscanRight(add, 7) == Collection<int>(std::vector<int> {7}));
+    assert(Collection<int>().tscanRight(add, 7, 4) == Collection<int>(std::vector<int> {7}));
+}
@@ -0,0 +1,48 @@
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+// Sum a Collection by recursing on its tail, which would be quadratic if
+// tail() copied its elements
+long
+sum_tail(Collection<int> c) {
+    long sum = 0;
+    while (c.size() > 0) {
+        sum += c.head();
+        c = c.tail();
+    }
+    return sum;
+}
+
+int main() {
+    auto c = range(10).materialize();
+
+    // views support the same operations as any other Collection
+    auto view = c.tail().init().slice(2, 5);
+    assert(view == Collection<int>(std::vector<int> {3, 4, 5}));
+    assert(view.map([](int x) { return x * 2; }) == Collection<int>(std::vector<int> {6, 8, 10}));
+    assert(view.reduceLeft([](int x, int y) { return x + y; }) == 12);
+    assert(view.sum() == 12);
+    assert(view.lazy().vector() == std::vector<int>({3, 4, 5}));
+
+    // transforming a temporary view in place leaves the shared elements alone
+    auto doubled = c.slice(0, 5).map([](int x) { return x * 2; });
+    auto odds = c.tail().filter([](int x) { return x % 2 == 1; });
+    assert(doubled == Collection<int>(std::vector<int> {0, 2, 4, 6, 8}));
+    assert(odds == Collection<int>(std::vector<int> {1, 3, 5, 7, 9}));
+    assert(c == range(10));
+
+    // a materialized view owns a copy of just its own elements
+    auto copy = c.slice(8, 10).materialize();
+    assert(copy == range(8, 10));
+    assert(std::move(copy).map([](int x) { return -x; }) == Collection<int>(std::vector<int> {-8, -9}));
+    assert(c == range(10));
+
+    assert(sum_tail(range(100000)) == 4999950000L);
+
+    auto flags = range(4).map([](int x) { return x % 2 == 0; });
+    assert(flags.tail() == Collection<bool>(std::vector<bool> {false, true, false}));
+}
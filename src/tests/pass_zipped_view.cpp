@@ -0,0 +1,59 @@
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <cassert>
+
+#include "../collections.h"
+
+using namespace cpp_collections;
+
+int main() {
+    auto ints = range(5);
+    auto doubles = range(5.0, 10.0);
+    auto strs = Collection<std::string>(std::vector<std::string> {"a", "b", "c", "d"});
+
+    auto zipped = zip(ints, doubles, strs);
+    assert(zipped.size() == 4);
+    assert(zipped[3] == std::make_tuple(3, 8.0, std::string("d")));
+
+    // functions take one argument per column
+    auto sums = zipped.map([](int x, double y, const std::string&) { return x + y; });
+    assert(sums == Collection<double>(std::vector<double> {5, 7, 9, 11}));
+
+    auto odd = zipped.filter([](int x, double, const std::string&) { return x % 2 == 1; });
+    assert(odd.size() == 2);
+    assert(odd.column<2>() == Collection<std::string>(std::vector<std::string> {"b", "d"}));
+    assert(odd.column<0>() == Collection<int>(std::vector<int> {1, 3}));
+
+    auto joined = zipped.foldLeft([](std::string acc, int, double, const std::string& s) {
+        return acc + s;
+    }, std::string());
+    assert(joined == "abcd");
+
+    int count = 0;
+    zipped.slice(1, 3).each([&](int x, double y, const std::string& s) {
+        assert(y == x + 5.0);
+        assert(s == std::string(1, char('a' + x)));
+        count++;
+    });
+    assert(count == 2);
+
+    // the columns are the zipped Collections, truncated to the shortest one
+    assert(zipped.column<0>() == range(4));
+
+    // rows past the shortest column cannot be sliced back in
+    bool threw = false;
+    try {
+        zipped.slice(2, 5);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // a view still converts to the Collection of tuples zip used to return
+    Collection<std::tuple<int, double, std::string>> rows = zip(ints, doubles, strs);
+    assert(rows.size() == 4);
+    assert(rows[0] == std::make_tuple(0, 5.0, std::string("a")));
+    assert(zipped.collect()[1] == std::make_tuple(1, 6.0, std::string("b")));
+}
@@ -0,0 +1,287 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+
+int detectedThreads = (std::thread::hardware_concurrency() == 0) ? \
+    4 : std::thread::hardware_concurrency();
+
+namespace cpp_collections {
+
+    // A fixed set of worker threads that parallel Collection operations
+    // submit their work to. Every worker owns a deque of tasks: it pushes and
+    // pops work at the back, and idle workers steal from the front of the
+    // other deques, which is where the largest unsplit ranges sit.
+    class ThreadPool {
+    private:
+        struct WorkerQueue {
+            std::mutex Lock;
+            std::deque<std::function<void()>> Tasks;
+        };
+
+        std::vector<std::thread> Workers;
+        // one deque per worker, plus a last one shared by outside threads
+        std::vector<std::unique_ptr<WorkerQueue>> Queues;
+        std::atomic<int> Pending;
+        std::atomic<bool> Stopping;
+        std::mutex SleepLock;
+        std::condition_variable Ready;
+
+        // Worker loop: run own, stolen or shared tasks until the pool is
+        // destroyed
+        void
+        work(int index);
+
+        // Return the pool the calling thread works for, if any
+        static ThreadPool*&
+        local_pool() {
+            static thread_local ThreadPool* pool = nullptr;
+            return pool;
+        };
+
+        // Return the deque index of the calling thread within local_pool()
+        static int&
+        local_index() {
+            static thread_local int index = 0;
+            return index;
+        };
+
+        // Return the deque the calling thread pushes to and pops from
+        int
+        queue_index() {
+            return local_pool() == this ? local_index() : Queues.size() - 1;
+        };
+
+        // Push a task onto the calling thread's deque and wake a worker
+        void
+        push(std::function<void()> task);
+
+        // Take a task from the back of deque 'index', or steal one from the
+        // front of any other deque
+        bool
+        pop(std::function<void()>& task, int index);
+
+        // Whether the calling thread's deque has no work left to be stolen
+        bool
+        local_queue_empty();
+
+    public:
+
+        // Start a pool with 'threads' workers
+        ThreadPool(int threads) : Pending(0), Stopping(false) {
+            for (int i = 0; i <= threads; i++)
+                Queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+            for (int i = 0; i < threads; i++)
+                Workers.push_back(std::thread([this, i]() { work(i); }));
+        };
+
+        // Stop and join all of the workers
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> guard(SleepLock);
+                Stopping = true;
+            }
+            Ready.notify_all();
+            for (auto& worker : Workers)
+                worker.join();
+        };
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Return the number of worker threads
+        int
+        size() const {
+            return Workers.size();
+        };
+
+        // Run one queued task on the calling thread, returning false if
+        // there was nothing to run or steal. The task allocates from the
+        // heap even if an arena is in scope on the calling thread.
+        bool
+        run_pending_task();
+
+        // Split [begin, end) into 'chunks' contiguous ranges and call
+        // func(chunk, chunk_begin, chunk_end) for each of them on the pool,
+        // on at most 'threads' threads at once. Ranges of chunks are split in
+        // half lazily, only once the thread working on them has had its
+        // queued work stolen, so the grain adapts to how busy the other
+        // workers are. The calling thread takes part and returns once every
+        // chunk has finished.
+        template<typename Function>
+        void
+        parallel_for(int begin, int end, int chunks, int threads, Function func);
+    };
+
+    // Worker loop: run own, stolen or shared tasks until the pool is destroyed
+    inline void
+    ThreadPool::work(int index) {
+        local_pool() = this;
+        local_index() = index;
+        while (true) {
+            std::function<void()> task;
+            if (pop(task, index)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(SleepLock);
+            Ready.wait(guard, [this]() { return Stopping || Pending > 0; });
+            if (Stopping && Pending == 0)
+                return;
+        }
+    }
+
+    // Push a task onto the calling thread's deque and wake a worker
+    inline void
+    ThreadPool::push(std::function<void()> task) {
+        WorkerQueue& queue = *Queues[queue_index()];
+        {
+            std::lock_guard<std::mutex> guard(queue.Lock);
+            queue.Tasks.push_back(std::move(task));
+        }
+        Pending++;
+        // taking the lock orders this wake-up after any worker that is
+        // between checking Pending and going to sleep
+        { std::lock_guard<std::mutex> guard(SleepLock); }
+        Ready.notify_one();
+    }
+
+    // Take a task from the back of deque 'index', or steal one from the front
+    // of any other deque
+    inline bool
+    ThreadPool::pop(std::function<void()>& task, int index) {
+        if (Pending == 0)
+            return false;
+        int queues = Queues.size();
+        for (int i = 0; i < queues; i++) {
+            int victim = (index + i) % queues;
+            WorkerQueue& queue = *Queues[victim];
+            std::lock_guard<std::mutex> guard(queue.Lock);
+            if (queue.Tasks.empty())
+                continue;
+            if (victim == index) {
+                task = std::move(queue.Tasks.back());
+                queue.Tasks.pop_back();
+            } else {
+                task = std::move(queue.Tasks.front());
+                queue.Tasks.pop_front();
+            }
+            Pending--;
+            return true;
+        }
+        return false;
+    }
+
+    // Whether the calling thread's deque has no work left to be stolen
+    inline bool
+    ThreadPool::local_queue_empty() {
+        WorkerQueue& queue = *Queues[queue_index()];
+        std::lock_guard<std::mutex> guard(queue.Lock);
+        return queue.Tasks.empty();
+    }
+
+    // Run one queued task on the calling thread, returning false if there was
+    // nothing to run or steal
+    inline bool
+    ThreadPool::run_pending_task() {
+        std::function<void()> task;
+        if (!pop(task, queue_index()))
+            return false;
+        // the task may belong to another caller, whose Collections must not
+        // be allocated from an arena in scope on this thread
+        Arena* arena = Arena::current();
+        Arena::current() = nullptr;
+        task();
+        Arena::current() = arena;
+        return true;
+    }
+
+    // Split [begin, end) into 'chunks' contiguous ranges and call
+    // func(chunk, chunk_begin, chunk_end) for each of them on the pool, on at
+    // most 'threads' threads at once
+    template<typename Function>
+    void
+    ThreadPool::parallel_for(int begin, int end, int chunks, int threads, Function func) {
+        int total = end - begin;
+        if (chunks > total)
+            chunks = total;
+        if (chunks <= 0)
+            return;
+
+        // the first (total % chunks) chunks take one extra element
+        int chunk = total / chunks;
+        int extra = total % chunks;
+        auto chunk_begin = [=](int i) {
+            return begin + i * chunk + std::min(i, extra);
+        };
+
+        if (chunks == 1 || threads <= 1 || Workers.empty()) {
+            for (int i = 0; i < chunks; i++)
+                func(i, chunk_begin(i), chunk_begin(i + 1));
+            return;
+        }
+
+        // every range of chunks is worked on by one thread at a time, so
+        // capping the ranges that are running or queued at 'threads' caps the
+        // threads that take part
+        std::atomic<int> remaining(chunks);
+        std::atomic<int> ranges(1);
+        std::function<void(int, int)> run = [&](int first, int last) {
+            int done = 0;
+            while (first < last) {
+                // hand the upper half of what is left to a thief whenever
+                // the previous half has been taken
+                while (last - first > 1 && local_queue_empty()) {
+                    if (ranges.fetch_add(1) >= threads) {
+                        ranges--;
+                        break;
+                    }
+                    int mid = first + (last - first) / 2;
+                    push([&run, mid, last]() { run(mid, last); });
+                    last = mid;
+                }
+                func(first, chunk_begin(first), chunk_begin(first + 1));
+                first++;
+                done++;
+            }
+            ranges--;
+            remaining.fetch_sub(done, std::memory_order_release);
+        };
+        run(0, chunks);
+
+        // help with queued work rather than blocking, so that nested parallel
+        // calls made from inside a worker can't starve the pool
+        while (remaining.load(std::memory_order_acquire) > 0)
+            if (!run_pending_task())
+                std::this_thread::yield();
+    }
+
+    // Return the number of chunks to split n elements into for 'threads'
+    // workers, leaving spare chunks for idle workers to steal when the cost
+    // of elements is uneven
+    inline int
+    parallel_chunks(int n, int threads) {
+        return std::max(1, std::min(n, threads * 8));
+    }
+
+    // Return the process-wide pool, starting it on first use. The calling
+    // thread always takes part in parallel_for, so one fewer worker than
+    // detectedThreads keeps every core busy.
+    inline ThreadPool&
+    thread_pool() {
+        static ThreadPool pool(detectedThreads > 1 ? detectedThreads - 1 : 0);
+        return pool;
+    }
+}
+
+#endif
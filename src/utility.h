@@ -11,6 +11,20 @@
 
 namespace cpp_collections {
 
+    // A compile-time list of indices, used to expand a tuple or a pack of
+    // columns element by element (std::index_sequence is C++14)
+    template<std::size_t ...I>
+    struct index_list {};
+
+    // Build index_list<0, 1, ..., N-1>
+    template<std::size_t N, std::size_t ...I>
+    struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+
+    template<std::size_t ...I>
+    struct make_index_list<0, I...> {
+        using type = index_list<I...>;
+    };
+
     // A class template to obtain the type and value of the subsequence 
     // [First,Last) of a tuple type TupleType
 